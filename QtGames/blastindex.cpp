@@ -0,0 +1,140 @@
+#include "blastindex.h"
+
+bool BlastIndex::Blast::reaches(int c, int r) const
+{
+    if (c == col) {
+        if (r == row) return true;
+        return r < row ? row - r <= arms[UP].length : r - row <= arms[DOWN].length;
+    }
+    if (r == row) {
+        return c < col ? col - c <= arms[LEFT].length : c - col <= arms[RIGHT].length;
+    }
+    return false;
+}
+
+BlastIndex::BlastIndex()
+    : m_tiles(nullptr)
+    , m_columns(0)
+    , m_rows(0)
+{
+}
+
+void BlastIndex::rebuild(const TileMap &tiles)
+{
+    m_tiles = &tiles;
+    m_columns = tiles.columns();
+    m_rows = tiles.rows();
+    for (QVector<qint16> &nearest : m_nearest) {
+        nearest.resize(m_columns * m_rows);
+    }
+
+    // 每行正反各扫一遍
+    for (int row = 0; row < m_rows; ++row) {
+        int last = -1;
+        for (int col = 0; col < m_columns; ++col) {
+            m_nearest[LEFT][index(col, row)] = qint16(last);
+            if (tiles.isBlocked(col, row)) last = col;
+        }
+        last = m_columns;
+        for (int col = m_columns - 1; col >= 0; --col) {
+            m_nearest[RIGHT][index(col, row)] = qint16(last);
+            if (tiles.isBlocked(col, row)) last = col;
+        }
+    }
+    // 每列正反各扫一遍
+    for (int col = 0; col < m_columns; ++col) {
+        int last = -1;
+        for (int row = 0; row < m_rows; ++row) {
+            m_nearest[UP][index(col, row)] = qint16(last);
+            if (tiles.isBlocked(col, row)) last = row;
+        }
+        last = m_rows;
+        for (int row = m_rows - 1; row >= 0; --row) {
+            m_nearest[DOWN][index(col, row)] = qint16(last);
+            if (tiles.isBlocked(col, row)) last = row;
+        }
+    }
+}
+
+void BlastIndex::clearObstacle(int col, int row)
+{
+    if (col < 0 || row < 0 || col >= m_columns || row >= m_rows) return;
+
+    // 行方向：(left, col] 的右侧障碍改为 right，[col, right) 的左侧障碍改为 left
+    const int i = index(col, row);
+    const int left = m_nearest[LEFT][i];
+    const int right = m_nearest[RIGHT][i];
+    for (int c = qMax(left, 0); c <= col; ++c) {
+        m_nearest[RIGHT][index(c, row)] = qint16(right);
+    }
+    for (int c = col + 1; c <= qMin(right, m_columns - 1); ++c) {
+        m_nearest[LEFT][index(c, row)] = qint16(left);
+    }
+
+    // 列方向同理
+    const int up = m_nearest[UP][i];
+    const int down = m_nearest[DOWN][i];
+    for (int r = qMax(up, 0); r <= row; ++r) {
+        m_nearest[DOWN][index(col, r)] = qint16(down);
+    }
+    for (int r = row + 1; r <= qMin(down, m_rows - 1); ++r) {
+        m_nearest[UP][index(col, r)] = qint16(up);
+    }
+}
+
+BlastIndex::Blast BlastIndex::blastAt(int col, int row, int range) const
+{
+    Blast blast;
+    blast.col = col;
+    blast.row = row;
+    const bool inside = m_tiles && col >= 0 && row >= 0 && col < m_columns && row < m_rows;
+    for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+        Arm &arm = blast.arms[dir];
+        if (!inside) {
+            arm.length = 0;
+            arm.stopper = TileMap::WALL;
+            continue;
+        }
+
+        // 到最近障碍物之间的空地数
+        const int obstacle = m_nearest[dir][index(col, row)];
+        const int origin = (dir == UP || dir == DOWN) ? row : col;
+        const int free = qAbs(obstacle - origin) - 1;
+        if (range <= free) {
+            arm.length = range;
+            arm.stopper = TileMap::EMPTY;
+            continue;
+        }
+
+        // 射程够到障碍物：砖块会被炸到，墙（含地图外）挡在外面
+        const QPoint d = direction(dir);
+        const QPoint hit(col + d.x() * (free + 1), row + d.y() * (free + 1));
+        arm.stopper = m_tiles->tileAt(hit.x(), hit.y());
+        arm.length = free + (arm.stopper == TileMap::BRICK ? 1 : 0);
+    }
+    return blast;
+}
+
+QList<QPoint> BlastIndex::positions(int col, int row, int range) const
+{
+    return positions(blastAt(col, row, range));
+}
+
+QList<QPoint> BlastIndex::positions(const Blast &blast)
+{
+    QList<QPoint> result;
+    forEachCell(blast, [&result](int col, int row) {
+        result.append(QPoint(col, row) * GameConstants::BLOCK_SIZE);
+    });
+    return result;
+}
+
+QPoint BlastIndex::direction(int dir)
+{
+    switch (dir) {
+    case UP:    return QPoint(0, -1);
+    case DOWN:  return QPoint(0, 1);
+    case LEFT:  return QPoint(-1, 0);
+    default:    return QPoint(1, 0);
+    }
+}
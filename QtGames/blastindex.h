@@ -0,0 +1,67 @@
+#ifndef BLASTINDEX_H
+#define BLASTINDEX_H
+
+#include <QList>
+#include <QPoint>
+#include <QVector>
+#include "tilemap.h"
+
+// 爆炸传播索引：记录每个方格在四个方向上最近的障碍物，相当于按行/列切出的空地段
+// 查询一个炸弹的火焰范围是 O(1)，列出火焰覆盖的方格是 O(R)，与方块数量无关
+// 砖块被炸掉时只合并它所在的那一行段和一列段
+class BlastIndex
+{
+public:
+    enum Direction { UP, DOWN, LEFT, RIGHT, DIRECTION_COUNT };
+
+    // 一个方向上的火焰：覆盖 length 个方格（被炸的砖块也算在内）
+    // stopper 是挡住火焰的地形，射程用完时为 EMPTY
+    struct Arm {
+        int length;
+        TileMap::Tile stopper;
+    };
+    struct Blast {
+        int col;
+        int row;
+        Arm arms[DIRECTION_COUNT];
+        bool reaches(int c, int r) const;  // 方格 (c, r) 是否在火焰里
+    };
+
+    BlastIndex();
+
+    void rebuild(const TileMap &tiles);  // 地图整体变化后重建，之后地形变化通过 clearObstacle 同步
+    void clearObstacle(int col, int row);  // 砖块被炸掉后合并两侧的空地段
+
+    Blast blastAt(int col, int row, int range) const;
+    // 火焰覆盖的所有位置（逻辑单位，方格原点），中心在最前
+    QList<QPoint> positions(int col, int row, int range) const;
+    static QList<QPoint> positions(const Blast &blast);
+    // 不分配内存地逐格访问火焰覆盖的方格：fn(col, row)，中心在最前
+    template <typename Fn>
+    static void forEachCell(const Blast &blast, Fn fn);
+
+    static QPoint direction(int dir);  // 方向对应的方格偏移
+
+private:
+    const TileMap *m_tiles;
+    int m_columns;
+    int m_rows;
+    // 每个方格在四个方向上最近障碍物的坐标（不含自身），没有障碍物时落在地图外
+    QVector<qint16> m_nearest[DIRECTION_COUNT];
+
+    int index(int col, int row) const { return row * m_columns + col; }
+};
+
+template <typename Fn>
+void BlastIndex::forEachCell(const Blast &blast, Fn fn)
+{
+    fn(blast.col, blast.row);
+    for (int dir = 0; dir < DIRECTION_COUNT; ++dir) {
+        const QPoint d = direction(dir);
+        for (int i = 1; i <= blast.arms[dir].length; ++i) {
+            fn(blast.col + d.x() * i, blast.row + d.y() * i);
+        }
+    }
+}
+
+#endif // BLASTINDEX_H
@@ -1,26 +1,41 @@
 #ifndef BOMB_H
 #define BOMB_H
 
-#include <QGraphicsEllipseItem>
 #include <QObject>
-#include <QTimer>
 #include <QList>
+#include <QPoint>
 #include "gameconstants.h"
+#include "timerwheel.h"
+#include "blastindex.h"
+#include "slotmap.h"
 
-class Bomb : public QObject, public QGraphicsEllipseItem
+// 炸弹的逻辑实体：位置、范围和爆炸状态，爆炸特效由渲染层负责
+class Bomb : public QObject
 {
     Q_OBJECT
 
 public:
-    Bomb(int x, int y, int range, QGraphicsItem *parent = nullptr);  // x, y是逻辑单位
+    Bomb(int x, int y, int range, QObject *parent = nullptr);  // x, y是逻辑单位
     
+    // 引信与火焰时长由 GameEngine 的时间轮调度，到期时调用下面两个函数
+    // 爆炸后火焰范围固定下来，之后即使砖块被炸掉也不再变化
     void explode();
+    void finishExplosion();
     bool isExploding() const { return m_isExploding; }
+    bool isFinished() const { return m_isFinished; }
+    TimerWheel::TimerId timerId() const { return m_timerId; }  // 当前的引信或火焰定时器
+    void setTimerId(TimerWheel::TimerId id) { m_timerId = id; }
+    EntityHandle handle() const { return m_handle; }  // 在 GameEngine 中的句柄
+    void setHandle(EntityHandle handle) { m_handle = handle; }
     int getRange() const { return m_range; }
-    QPointF getBombPosition() const;
+    QPoint getBombPosition() const { return m_pos; }  // 逻辑单位，总是对齐到方格
     
-    // 获取爆炸范围的所有位置（返回逻辑单位）
+    // 爆炸后火焰覆盖的所有位置（返回逻辑单位），给渲染层用
     QList<QPoint> getExplosionPositions() const;
+    // 火焰范围：放下时由引擎算好，未爆炸期间只在射线上的砖块被炸掉时刷新
+    // 逐格访问请用 BlastIndex::forEachCell，不分配内存
+    const BlastIndex::Blast& blast() const { return m_blast; }
+    void setBlast(const BlastIndex::Blast &blast) { if (!m_isExploding) m_blast = blast; }
     
     // 炸弹大小为4个单位x4个单位，显示时转换为像素
     enum : int {
@@ -29,21 +44,17 @@ public:
     };
 
 signals:
+    void explosionStarted(Bomb *bomb);
     void explosionFinished(Bomb *bomb);
 
-private slots:
-    void onExplosionTimeout();
-
 private:
+    QPoint m_pos;
     int m_range;
     bool m_isExploding;
-    QTimer *m_explosionTimer;
-    QList<QGraphicsRectItem*> m_explosionEffects;
-    
-    void createExplosionEffects();
-    void removeExplosionEffects();
-    
-    static const int EXPLOSION_DURATION = 400;  // 爆炸持续400ms
+    bool m_isFinished;
+    TimerWheel::TimerId m_timerId;
+    EntityHandle m_handle;
+    BlastIndex::Blast m_blast;
 };
 
 #endif // BOMB_H
@@ -0,0 +1,39 @@
+#include "bombitem.h"
+#include "bomb.h"
+#include <QBrush>
+#include <QPen>
+
+BombItem::BombItem(const Bomb *bomb, QGraphicsItem *parent)
+    : QGraphicsEllipseItem(0, 0, Bomb::SIZE_PIXELS, Bomb::SIZE_PIXELS, parent)
+{
+    // 逻辑单位换算成像素
+    setPos(bomb->getBombPosition() * GameConstants::UNIT_SIZE);
+    
+    // 设置炸弹外观 - 黑色圆形
+    setBrush(QBrush(Qt::black));
+    setPen(QPen(Qt::darkGray, 1));
+}
+
+void BombItem::showExplosion(const QList<QPoint> &positions)
+{
+    for (const QPoint &pos : positions) {
+        // pos是逻辑单位，转换为像素显示；特效作为子图元，随炸弹图元一起销毁
+        QGraphicsRectItem *effect = new QGraphicsRectItem(0, 0, Bomb::SIZE_PIXELS, Bomb::SIZE_PIXELS, this);
+        effect->setPos(pos.x() * GameConstants::UNIT_SIZE - x(), pos.y() * GameConstants::UNIT_SIZE - y());
+        
+        // 爆炸特效 - 红色半透明
+        QBrush brush(QColor(255, 0, 0, 150));
+        effect->setBrush(brush);
+        effect->setPen(QPen(Qt::red, 2));
+        
+        m_explosionEffects.append(effect);
+    }
+}
+
+void BombItem::clearExplosion()
+{
+    for (QGraphicsRectItem *effect : m_explosionEffects) {
+        delete effect;
+    }
+    m_explosionEffects.clear();
+}
@@ -0,0 +1,23 @@
+#ifndef BOMBITEM_H
+#define BOMBITEM_H
+
+#include <QGraphicsEllipseItem>
+#include <QList>
+#include <QPoint>
+
+class Bomb;
+
+// 炸弹的显示图元，爆炸时负责显示/移除火焰特效
+class BombItem : public QGraphicsEllipseItem
+{
+public:
+    explicit BombItem(const Bomb *bomb, QGraphicsItem *parent = nullptr);
+    
+    void showExplosion(const QList<QPoint> &positions);  // 逻辑单位
+    void clearExplosion();
+
+private:
+    QList<QGraphicsRectItem*> m_explosionEffects;
+};
+
+#endif // BOMBITEM_H
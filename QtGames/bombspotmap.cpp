@@ -0,0 +1,88 @@
+#include "bombspotmap.h"
+#include "tilemap.h"
+#include "walkabilitymap.h"
+
+namespace {
+const QPoint CELL_STEPS[4] = { QPoint(1, 0), QPoint(-1, 0), QPoint(0, 1), QPoint(0, -1) };
+}
+
+void BombSpotMap::rebuild(const TileMap &tiles, const WalkabilityMap &walkability, const BlastIndex &blasts,
+                          const DangerTimeline &timeline, quint64 now, int range)
+{
+    m_range = range;
+    const int columns = tiles.columns();
+    const int rows = tiles.rows();
+    if (m_safe.width() != columns || m_safe.height() != rows) {
+        m_safe.resize(columns, rows);
+        m_passable.resize(columns, rows);
+    } else {
+        m_safe.clear();
+        m_passable.clear();
+    }
+
+    // 能经过的方格和落脚点：已经熄灭的火焰不用管，引信烧完以后才起火的方格可以路过但不能停
+    const quint64 fuseEnd = now + GameConstants::BOMB_FUSE_TICKS;
+    m_sources.resize(0);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < columns; ++col) {
+            if (tiles.tileAt(col, row) != TileMap::EMPTY || walkability.hasBomb(col, row)) continue;
+            const DangerTimeline::Window &window = timeline.windowAt(col, row);
+            const bool settled = window.isEmpty() || window.end <= now + 1;
+            if (!settled && window.start <= fuseEnd) continue;
+            m_passable.set(col, row);
+            if (settled) m_sources.append(QPoint(col, row));
+        }
+    }
+
+    // 反向的一遍：从落脚点往外展开
+    m_rest.compute(columns, rows, m_sources, [this](int col, int row) {
+        return m_passable.test(col, row);
+    });
+
+    m_passable.forEachSet([this, &blasts, range](int col, int row) {
+        if (escapes(blasts.blastAt(col, row, range))) m_safe.set(col, row);
+    });
+}
+
+bool BombSpotMap::escapes(const BlastIndex::Blast &blast) const
+{
+    for (int dir = 0; dir < BlastIndex::DIRECTION_COUNT; ++dir) {
+        const QPoint d = BlastIndex::direction(dir);
+        const BlastIndex::Arm &arm = blast.arms[dir];
+        QPoint cell(blast.col, blast.row);
+        for (int k = 1; k <= arm.length && k <= BUDGET_CELLS; ++k) {
+            cell += d;
+            // 砖块或别的炸弹挡住，这条臂走不下去
+            if (!m_passable.test(cell.x(), cell.y())) break;
+            // 从臂上往两侧拐出十字
+            const QPoint side(d.y(), d.x());
+            if (descends(blast, cell + side, k + 1) || descends(blast, cell - side, k + 1)) return true;
+            // 射程用完而不是被挡住：沿臂继续往前也能走出火焰
+            if (k == arm.length && arm.stopper == TileMap::EMPTY && descends(blast, cell + d, k + 1)) return true;
+        }
+    }
+    return false;
+}
+
+bool BombSpotMap::descends(const BlastIndex::Blast &blast, QPoint from, int cost) const
+{
+    if (!m_passable.test(from.x(), from.y()) || blast.reaches(from.x(), from.y())) return false;
+    int dist = m_rest.distanceAt(from.x(), from.y());
+    while (dist > 0) {
+        if (dist == DistanceField::UNREACHABLE || cost + dist > BUDGET_CELLS) return false;
+        // 选一个更近的邻居，最近的落脚点在十字里时不能回去
+        bool moved = false;
+        for (const QPoint &d : CELL_STEPS) {
+            const QPoint next = from + d;
+            if (m_rest.distanceAt(next.x(), next.y()) != dist - 1) continue;
+            if (blast.reaches(next.x(), next.y())) continue;
+            from = next;
+            moved = true;
+            break;
+        }
+        if (!moved) return false;
+        --dist;
+        ++cost;
+    }
+    return cost <= BUDGET_CELLS;
+}
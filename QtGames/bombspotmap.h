@@ -0,0 +1,52 @@
+#ifndef BOMBSPOTMAP_H
+#define BOMBSPOTMAP_H
+
+#include <QPoint>
+#include <QVector>
+#include <QtGlobal>
+#include "blastindex.h"
+#include "dangertimeline.h"
+#include "distancefield.h"
+#include "gameconstants.h"
+#include "gridbitset.h"
+
+class TileMap;
+class WalkabilityMap;
+
+// 安全放弹位置表：对每个空地方格标记“站在这里放一颗炸弹，放的人还能在引信内躲开”
+// 先从所有之后不会起火的方格反向做一次多源 BFS，得到每格到最近落脚点的格数；
+// 再逐格看这颗炸弹的十字：从火焰臂上拐出去（或从射程尽头走出去），
+// 沿距离场下降且不回到十字里，引信烧完前能到落脚点就算安全
+// 每次决策算一次，所有机器人放炸弹前只需查一位
+class BombSpotMap
+{
+public:
+    // range 是假想炸弹的射程（放炸弹的机器人的射程）
+    void rebuild(const TileMap &tiles, const WalkabilityMap &walkability, const BlastIndex &blasts,
+                 const DangerTimeline &timeline, quint64 now, int range);
+
+    int range() const { return m_range; }
+
+    bool isSafe(int col, int row) const { return m_safe.test(col, row); }
+    // 到最近落脚点（之后不会起火的空地）的格数，走不到时为 DistanceField::UNREACHABLE
+    quint16 restDistance(int col, int row) const { return m_rest.distanceAt(col, row); }
+
+private:
+    // 走一格要几个 tick（每 MOVE_STEP_TICKS 个 tick 走一个逻辑单位）
+    static constexpr int CELL_TICKS = GameConstants::BLOCK_SIZE * GameConstants::MOVE_STEP_TICKS;
+    // 引信内最多能走几格；留一次决策的延迟
+    static constexpr int BUDGET_CELLS =
+        (GameConstants::BOMB_FUSE_TICKS - GameConstants::BOT_THINK_TICKS) / CELL_TICKS;
+
+    int m_range = -1;  // 上次重建用的射程
+    GridBitset m_safe;
+    GridBitset m_passable;  // 空地、没有炸弹、引信烧完之前不会起火
+    DistanceField m_rest;
+    QVector<QPoint> m_sources;  // 复用的源点列表
+
+    bool escapes(const BlastIndex::Blast &blast) const;
+    // 从十字外的方格 from 出发（已经走了 cost 格），沿距离场下降能否及时到达落脚点
+    bool descends(const BlastIndex::Blast &blast, QPoint from, int cost) const;
+};
+
+#endif // BOMBSPOTMAP_H
@@ -0,0 +1,118 @@
+#include "cellregions.h"
+#include "tilemap.h"
+#include <utility>
+
+void CellRegions::rebuild(const TileMap &tiles, bool openBricks)
+{
+    m_columns = tiles.columns();
+    m_rows = tiles.rows();
+    const int cells = m_columns * m_rows;
+    m_parent.fill(-1, cells);
+    m_size.fill(0, cells);
+    m_rootBlockers.fill(0, cells);
+    m_blockers.fill(0, cells);
+
+    for (int row = 0; row < m_rows; ++row) {
+        for (int col = 0; col < m_columns; ++col) {
+            const TileMap::Tile tile = tiles.tileAt(col, row);
+            if (tile == TileMap::EMPTY || (openBricks && tile == TileMap::BRICK)) {
+                const int i = index(col, row);
+                m_parent[i] = i;
+                m_size[i] = 1;
+            }
+        }
+    }
+    // 只需要和左边、上边合并，每条边看一次
+    for (int row = 0; row < m_rows; ++row) {
+        for (int col = 0; col < m_columns; ++col) {
+            if (!isOpen(col, row)) continue;
+            if (isOpen(col - 1, row)) unite(index(col, row), index(col - 1, row));
+            if (isOpen(col, row - 1)) unite(index(col, row), index(col, row - 1));
+        }
+    }
+}
+
+void CellRegions::openCell(int col, int row)
+{
+    if (!contains(col, row) || isOpen(col, row)) return;
+    const int i = index(col, row);
+    m_parent[i] = i;
+    m_size[i] = 1;
+    m_rootBlockers[i] = m_blockers[i];
+    const QPoint neighbors[4] = { QPoint(col + 1, row), QPoint(col - 1, row), QPoint(col, row + 1), QPoint(col, row - 1) };
+    for (const QPoint &n : neighbors) {
+        if (isOpen(n.x(), n.y())) unite(i, index(n.x(), n.y()));
+    }
+}
+
+void CellRegions::addBlocker(int col, int row)
+{
+    if (!contains(col, row)) return;
+    const int i = index(col, row);
+    ++m_blockers[i];
+    if (m_parent[i] >= 0) ++m_rootBlockers[find(i)];
+}
+
+void CellRegions::removeBlocker(int col, int row)
+{
+    if (!contains(col, row)) return;
+    const int i = index(col, row);
+    if (m_blockers[i] == 0) return;
+    --m_blockers[i];
+    if (m_parent[i] >= 0) --m_rootBlockers[find(i)];
+}
+
+bool CellRegions::connected(const QPoint &a, const QPoint &b) const
+{
+    if (!isOpen(a.x(), a.y()) || !isOpen(b.x(), b.y())) return false;
+    return find(index(a.x(), a.y())) == find(index(b.x(), b.y()));
+}
+
+bool CellRegions::reachable(const QPoint &a, const QPoint &b) const
+{
+    if (!connected(a, b)) return false;
+    const int start = index(a.x(), a.y());
+    const int goal = index(b.x(), b.y());
+    if (start == goal || m_rootBlockers[find(start)] == 0) return true;
+
+    // 区域里有炸弹：只在这个区域里 BFS，炸弹所在方格不能经过（终点除外）
+    m_search.begin(m_columns * m_rows);
+    m_search.visit(start, start);
+    while (!m_search.isEmpty()) {
+        const int cur = m_search.pop();
+        const int col = cur % m_columns;
+        const int row = cur / m_columns;
+        const QPoint neighbors[4] = { QPoint(col + 1, row), QPoint(col - 1, row), QPoint(col, row + 1), QPoint(col, row - 1) };
+        for (const QPoint &n : neighbors) {
+            if (!isOpen(n.x(), n.y())) continue;
+            const int next = index(n.x(), n.y());
+            if (m_search.isVisited(next)) continue;
+            if (next == goal) return true;
+            if (m_blockers[next] > 0) continue;
+            m_search.visit(next, cur);
+        }
+    }
+    return false;
+}
+
+int CellRegions::find(int i) const
+{
+    // 路径减半
+    while (m_parent[i] != i) {
+        m_parent[i] = m_parent[m_parent[i]];
+        i = m_parent[i];
+    }
+    return i;
+}
+
+void CellRegions::unite(int a, int b)
+{
+    a = find(a);
+    b = find(b);
+    if (a == b) return;
+    // 按大小合并，小的挂到大的下面
+    if (m_size[a] < m_size[b]) std::swap(a, b);
+    m_parent[b] = a;
+    m_size[a] += m_size[b];
+    m_rootBlockers[a] += m_rootBlockers[b];
+}
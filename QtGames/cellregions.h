@@ -0,0 +1,51 @@
+#ifndef CELLREGIONS_H
+#define CELLREGIONS_H
+
+#include <QPoint>
+#include <QVector>
+#include <QtGlobal>
+#include "searchworkspace.h"
+
+class TileMap;
+
+// 空地方格的连通区域（并查集）：地形只会因为砖块被炸掉而变得更连通，
+// 所以砖块消失时合并相邻区域即可，查询两格是否连通接近 O(1)
+// 炸弹只是暂时挡路，单独记在覆盖层里：区域里没有炸弹时直接按并查集回答，
+// 有炸弹时才在这个区域里做一次绕开炸弹的 BFS
+class CellRegions
+{
+public:
+    // openBricks 为 true 时把砖块也当作空地，用于校验地图（砖块全部炸掉后的连通性）
+    void rebuild(const TileMap &tiles, bool openBricks = false);
+    void openCell(int col, int row);  // 砖块被炸掉
+
+    // 炸弹覆盖层：未爆炸的炸弹挡住所在方格
+    void addBlocker(int col, int row);
+    void removeBlocker(int col, int row);
+
+    bool isOpen(int col, int row) const {
+        return contains(col, row) && m_parent[index(col, row)] >= 0;
+    }
+    // 只看地形：两格都是空地且在同一区域
+    bool connected(const QPoint &a, const QPoint &b) const;
+    // 同时绕开炸弹；起点和终点所在方格本身有炸弹也算（站在自己刚放的炸弹上）
+    bool reachable(const QPoint &a, const QPoint &b) const;
+
+private:
+    int m_columns = 0;
+    int m_rows = 0;
+    mutable QVector<qint32> m_parent;  // -1 表示不是空地；查询时顺带压缩路径
+    QVector<qint32> m_size;            // 根节点上的区域大小
+    QVector<qint32> m_rootBlockers;    // 根节点上的区域内炸弹数
+    QVector<quint8> m_blockers;        // 每格炸弹数
+    mutable SearchWorkspace m_search;  // reachable() 回退 BFS 用的复用内存
+
+    bool contains(int col, int row) const {
+        return col >= 0 && row >= 0 && col < m_columns && row < m_rows;
+    }
+    int index(int col, int row) const { return row * m_columns + col; }
+    int find(int i) const;
+    void unite(int a, int b);
+};
+
+#endif // CELLREGIONS_H
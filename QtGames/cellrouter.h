@@ -0,0 +1,99 @@
+#ifndef CELLROUTER_H
+#define CELLROUTER_H
+
+#include <QPoint>
+#include <QVector>
+#include "distancefield.h"
+#include "gameconstants.h"
+#include "searchworkspace.h"
+
+// 分层寻路：障碍物只出现在方格上，远距离路线在 25x25 的方格图上算距离场，
+// 机器人不在方格原点时，只在它压着的那几格里按逻辑单位做一次局部搜索，
+// 找到走回方格原点最省的一条再接上方格路线。比逐单位展开少 BLOCK_SIZE^2 倍的节点
+class CellRouter
+{
+public:
+    // sources 是方格坐标；passable(col, row) 决定方格能否经过
+    template <typename Passable>
+    void compute(int columns, int rows, const QVector<QPoint> &sources, Passable passable) {
+        m_cells.compute(columns, rows, sources, passable);
+    }
+
+    const DistanceField &cells() const { return m_cells; }
+
+    // 从逻辑单位位置 pos 朝最近的源方格走一步（一个逻辑单位）
+    // 已经站在源方格原点上时 step 为 (0, 0)；walkable(x, y) 是逻辑单位位置能否停留
+    // 到不了时返回 false
+    template <typename Walkable>
+    bool nextStep(const QPoint &pos, Walkable walkable, QPoint &step) const;
+
+private:
+    enum : int {
+        LOCAL_SIDE = GameConstants::BLOCK_SIZE + 1,
+        LOCAL_SIZE = LOCAL_SIDE * LOCAL_SIDE
+    };
+
+    DistanceField m_cells;
+    mutable SearchWorkspace m_local;  // 局部细化用，节点是窗口里的逻辑单位位置
+};
+
+template <typename Walkable>
+bool CellRouter::nextStep(const QPoint &pos, Walkable walkable, QPoint &step) const
+{
+    const int size = GameConstants::BLOCK_SIZE;
+    const int col = pos.x() / size;
+    const int row = pos.y() / size;
+    const int offsetX = pos.x() % size;
+    const int offsetY = pos.y() % size;
+
+    // 正好在方格原点：直接沿方格距离场走，一格的方向就是一个逻辑单位的方向
+    if (offsetX == 0 && offsetY == 0) {
+        return m_cells.descend(QPoint(col, row), step);
+    }
+
+    // 局部细化：在压着的方格范围内（最多 (BLOCK_SIZE+1)^2 个位置）做 BFS，
+    // 代价 = 走到某个方格原点的单位步数 + 该方格到源的格数 * BLOCK_SIZE
+    const int spanX = offsetX ? size : 0;
+    const int spanY = offsetY ? size : 0;
+    const int width = spanX + 1;
+    const QPoint base(col * size, row * size);
+    const int start = offsetY * width + offsetX;
+    m_local.begin(LOCAL_SIZE);
+    m_local.visit(start, start);
+
+    int best = -1;
+    int bestCost = 0;
+    while (!m_local.isEmpty()) {
+        const int cur = m_local.pop();
+        const int x = cur % width;
+        const int y = cur / width;
+        if (x % size == 0 && y % size == 0) {
+            const quint16 cells = m_cells.distanceAt(col + x / size, row + y / size);
+            if (cells != DistanceField::UNREACHABLE) {
+                const int cost = m_local.depthOf(cur) + int(cells) * size;
+                if (best < 0 || cost < bestCost) {
+                    best = cur;
+                    bestCost = cost;
+                }
+            }
+        }
+        const QPoint moves[4] = { QPoint(1, 0), QPoint(-1, 0), QPoint(0, 1), QPoint(0, -1) };
+        for (const QPoint &d : moves) {
+            const int nx = x + d.x();
+            const int ny = y + d.y();
+            if (nx < 0 || ny < 0 || nx > spanX || ny > spanY) continue;
+            const int next = ny * width + nx;
+            if (m_local.isVisited(next)) continue;
+            if (!walkable(base.x() + nx, base.y() + ny)) continue;
+            m_local.visit(next, cur);
+        }
+    }
+    if (best < 0) return false;
+
+    // 回溯到起点后的第一步
+    const int first = m_local.firstAfterSource(best);
+    step = QPoint(first % width - offsetX, first / width - offsetY);
+    return true;
+}
+
+#endif // CELLROUTER_H
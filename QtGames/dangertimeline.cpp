@@ -0,0 +1,99 @@
+#include "dangertimeline.h"
+#include "gameconstants.h"
+#include <algorithm>
+
+void DangerTimeline::reset(int columns, int rows)
+{
+    m_columns = columns;
+    m_rows = rows;
+    m_windows.fill(Window(), columns * rows);
+    m_pendingAt.fill(-1, columns * rows);
+    m_touched.clear();
+}
+
+void DangerTimeline::rebuild(quint64 now, const QVector<Fuse> &fuses)
+{
+    for (int index : m_touched) {
+        m_windows[index] = Window();
+    }
+    m_touched.resize(0);
+
+    // 正在燃烧的火焰从现在一直到熄灭；未爆炸的炸弹先登记在所在方格上，等火焰来点燃
+    m_detonateAt.fill(NEVER, fuses.size());
+    m_order.resize(0);
+    for (int i = 0; i < fuses.size(); ++i) {
+        const Fuse &fuse = fuses[i];
+        if (fuse.burning) {
+            mark(fuse.blast, now, fuse.at);
+            continue;
+        }
+        const int cell = fuse.blast.row * m_columns + fuse.blast.col;
+        m_pendingAt[cell] = i;
+        m_detonateAt[i] = fuse.at;
+        m_order.append(i);
+    }
+    std::sort(m_order.begin(), m_order.end(), [&fuses](int a, int b) {
+        return fuses[a].at < fuses[b].at;
+    });
+
+    // 按引信先后引爆；引爆时火焰碰到的炸弹在同一 tick 连锁爆炸，与引擎的结算方式一致
+    // 已经被连锁引爆的炸弹从方格上摘掉，轮到它的引信时直接跳过
+    for (int first : m_order) {
+        const int firstCell = fuses[first].blast.row * m_columns + fuses[first].blast.col;
+        if (m_pendingAt[firstCell] != first) continue;
+        m_pendingAt[firstCell] = -1;
+
+        const quint64 at = m_detonateAt[first];
+        m_chain.resize(0);
+        m_chain.append(first);
+        for (int head = 0; head < m_chain.size(); ++head) {
+            const int bomb = m_chain[head];
+            m_detonateAt[bomb] = at;
+            const BlastIndex::Blast &blast = fuses[bomb].blast;
+            mark(blast, at, at + GameConstants::EXPLOSION_TICKS);
+
+            auto ignite = [this](int col, int row) {
+                qint32 &hit = m_pendingAt[row * m_columns + col];
+                if (hit >= 0) {
+                    m_chain.append(hit);
+                    hit = -1;
+                }
+            };
+            ignite(blast.col, blast.row);
+            for (int dir = 0; dir < BlastIndex::DIRECTION_COUNT; ++dir) {
+                const QPoint d = BlastIndex::direction(dir);
+                for (int i = 1; i <= blast.arms[dir].length; ++i) {
+                    ignite(blast.col + d.x() * i, blast.row + d.y() * i);
+                }
+            }
+        }
+    }
+}
+
+int DangerTimeline::ticksUntilFlame(int col, int row, quint64 now) const
+{
+    const Window &window = windowAt(col, row);
+    if (window.isEmpty() || window.end <= now) return -1;
+    return window.start <= now ? 0 : int(window.start - now);
+}
+
+void DangerTimeline::mark(const BlastIndex::Blast &blast, quint64 start, quint64 end)
+{
+    // 同一方格被多颗炸弹炸到时取最早起火、最晚熄灭，中间的空档也算危险
+    auto merge = [this, start, end](int col, int row) {
+        const int index = row * m_columns + col;
+        Window &window = m_windows[index];
+        if (window.isEmpty()) {
+            m_touched.append(index);
+        }
+        window.start = qMin(window.start, start);
+        window.end = qMax(window.end, end);
+    };
+    merge(blast.col, blast.row);
+    for (int dir = 0; dir < BlastIndex::DIRECTION_COUNT; ++dir) {
+        const QPoint d = BlastIndex::direction(dir);
+        for (int i = 1; i <= blast.arms[dir].length; ++i) {
+            merge(blast.col + d.x() * i, blast.row + d.y() * i);
+        }
+    }
+}
@@ -0,0 +1,64 @@
+#ifndef DANGERTIMELINE_H
+#define DANGERTIMELINE_H
+
+#include <QVector>
+#include <QtGlobal>
+#include "blastindex.h"
+
+// 每个方格的火焰时间窗：最早什么时候起火、最晚什么时候熄灭（定时器时钟，左闭右开）
+// 由所有炸弹的引信推算，包括连锁引爆提前的部分
+// 炸弹放下、爆炸、熄灭或地形变化时只标记过期，下一次查询时整体重建，查询是 O(1)
+// 整体重建只看场上的几颗炸弹，比按连锁关系增量修补简单得多，开销也在同一量级
+class DangerTimeline
+{
+public:
+    static constexpr quint64 NEVER = ~quint64(0);
+
+    struct Window {
+        quint64 start = NEVER;  // 没有火焰时为 NEVER
+        quint64 end = 0;
+        bool isEmpty() const { return start == NEVER; }
+        bool covers(quint64 tick) const { return tick >= start && tick < end; }
+    };
+
+    // 一颗炸弹的输入：未爆炸的给出引信到期时间，正在燃烧的给出火焰熄灭时间
+    struct Fuse {
+        BlastIndex::Blast blast;
+        quint64 at;
+        bool burning;
+    };
+
+    void reset(int columns, int rows);
+    // 从当前所有炸弹重新推算；now 是当前定时器时间
+    void rebuild(quint64 now, const QVector<Fuse> &fuses);
+
+    const Window &windowAt(int col, int row) const {
+        static const Window none;
+        if (col < 0 || row < 0 || col >= m_columns || row >= m_rows) return none;
+        return m_windows[row * m_columns + col];
+    }
+    // 距离起火还有多少 tick：已经在烧为 0，不会起火为 -1
+    int ticksUntilFlame(int col, int row, quint64 now) const;
+
+    // 遍历所有有火焰的方格：fn(col, row, window)
+    template <typename Fn>
+    void forEachWindow(Fn fn) const {
+        for (int index : m_touched) {
+            fn(index % m_columns, index / m_columns, m_windows[index]);
+        }
+    }
+
+private:
+    int m_columns = 0;
+    int m_rows = 0;
+    QVector<Window> m_windows;
+    QVector<qint32> m_touched;       // 有时间窗的方格，重建时只清这些
+    QVector<qint32> m_pendingAt;     // 每个方格上未爆炸炸弹的输入下标，-1 表示没有
+    QVector<quint64> m_detonateAt;   // 每颗未爆炸炸弹的预计爆炸时间（连锁引爆会比引信早）
+    QVector<qint32> m_order;         // 按引信排序的未爆炸炸弹
+    QVector<qint32> m_chain;         // 同一时刻连锁引爆的队列
+
+    void mark(const BlastIndex::Blast &blast, quint64 start, quint64 end);
+};
+
+#endif // DANGERTIMELINE_H
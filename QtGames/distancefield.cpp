@@ -0,0 +1,28 @@
+#include "distancefield.h"
+#include "gameconstants.h"
+
+// 与机器人 BFS 的扩展顺序一致，距离相同时按这个顺序取方向
+const QPoint DistanceField::STEPS[4] = {
+    QPoint(GameConstants::LOGIC_UNIT, 0), QPoint(-GameConstants::LOGIC_UNIT, 0),
+    QPoint(0, GameConstants::LOGIC_UNIT), QPoint(0, -GameConstants::LOGIC_UNIT)
+};
+
+bool DistanceField::descend(const QPoint &from, QPoint &step) const
+{
+    quint16 best = distanceAt(from.x(), from.y());
+    if (best == 0) {
+        step = QPoint(0, 0);
+        return true;
+    }
+
+    bool found = false;
+    for (const QPoint &d : STEPS) {
+        const quint16 dist = distanceAt(from.x() + d.x(), from.y() + d.y());
+        if (dist < best) {
+            best = dist;
+            step = d;
+            found = true;
+        }
+    }
+    return found;
+}
@@ -0,0 +1,70 @@
+#ifndef DISTANCEFIELD_H
+#define DISTANCEFIELD_H
+
+#include <QPoint>
+#include <QVector>
+#include <QtGlobal>
+#include "searchworkspace.h"
+
+// 逻辑单位网格上的多源 BFS 距离场：每个位置到最近源点的步数
+// 每次决策算一次，所有机器人共用，选方向只需比较四个邻居（沿梯度下降）
+// 距离直接读搜索工作区里的深度，重算时不用把整张表填一遍
+class DistanceField
+{
+public:
+    enum : quint16 { UNREACHABLE = 0xFFFF };
+
+    // 源点距离为 0（源点本身不要求可通行），passable(x, y) 决定其他位置能否经过
+    template <typename Passable>
+    void compute(int width, int height, const QVector<QPoint> &sources, Passable passable);
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    quint16 distanceAt(int x, int y) const {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height) return UNREACHABLE;
+        const int i = y * m_width + x;
+        return m_search.isVisited(i) ? quint16(m_search.depthOf(i)) : quint16(UNREACHABLE);
+    }
+    bool isReachable(int x, int y) const { return distanceAt(x, y) != UNREACHABLE; }
+
+    // 从 from 出发沿梯度走一步：已经在源点上时 step 为 (0, 0)
+    // 没有比当前更近的邻居（不可达）时返回 false
+    bool descend(const QPoint &from, QPoint &step) const;
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    SearchWorkspace m_search;
+
+    static const QPoint STEPS[4];
+};
+
+template <typename Passable>
+void DistanceField::compute(int width, int height, const QVector<QPoint> &sources, Passable passable)
+{
+    m_width = width;
+    m_height = height;
+    m_search.begin(width * height);
+
+    for (const QPoint &s : sources) {
+        if (s.x() < 0 || s.y() < 0 || s.x() >= width || s.y() >= height) continue;
+        const int i = s.y() * width + s.x();
+        m_search.visit(i, i);
+    }
+    while (!m_search.isEmpty()) {
+        const int cur = m_search.pop();
+        const int cx = cur % width;
+        const int cy = cur / width;
+        for (const QPoint &d : STEPS) {
+            const int nx = cx + d.x();
+            const int ny = cy + d.y();
+            if (nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+            const int ni = ny * width + nx;
+            if (m_search.isVisited(ni)) continue;
+            if (!passable(nx, ny)) continue;
+            m_search.visit(ni, cur);
+        }
+    }
+}
+
+#endif // DISTANCEFIELD_H
@@ -0,0 +1,23 @@
+#include "escapeplanner.h"
+
+// 等待放在最后：同样快的路线里优先走动
+const QPoint EscapePlanner::MOVES[5] = {
+    QPoint(GameConstants::LOGIC_UNIT, 0), QPoint(-GameConstants::LOGIC_UNIT, 0),
+    QPoint(0, GameConstants::LOGIC_UNIT), QPoint(0, -GameConstants::LOGIC_UNIT),
+    QPoint(0, 0)
+};
+
+void EscapePlanner::trace(int state, Plan &result) const
+{
+    // 第 k 层状态与它的父状态（第 k-1 层）的位移就是第 k 步
+    result.firstStep = QPoint(0, 0);
+    while (state >= LAYER) {
+        const int parent = m_search.parentOf(state);
+        const int local = state % LAYER;
+        const int from = parent % LAYER;
+        const QPoint move(local % SIDE - from % SIDE, local / SIDE - from / SIDE);
+        result.moves[state / LAYER - 1] = move;
+        result.firstStep = move;
+        state = parent;
+    }
+}
@@ -0,0 +1,146 @@
+#ifndef ESCAPEPLANNER_H
+#define ESCAPEPLANNER_H
+
+#include <QPoint>
+#include <QVector>
+#include <QtGlobal>
+#include "dangertimeline.h"
+#include "gameconstants.h"
+#include "searchworkspace.h"
+#include "tilemap.h"
+
+// 时空逃生规划：状态是（位置, 第几步），按移动节奏每 MOVE_STEP_TICKS 个 tick 走一个逻辑单位或原地等待
+// 对照危险时间线检查每一步身体压到的方格在这段时间内会不会起火，
+// 找到最早到达“之后再也不会起火”的位置的路线；同样快的路线里取终点评分最高的
+// 只搜索以起点为中心、半径为视野步数的窗口，访问标记和队列都复用，不做堆分配
+class EscapePlanner
+{
+public:
+    // 引信加火焰时长内一定能分出结果，更远的不用看
+    static constexpr int HORIZON_STEPS =
+        (GameConstants::BOMB_FUSE_TICKS + GameConstants::EXPLOSION_TICKS) / GameConstants::MOVE_STEP_TICKS + 1;
+
+    struct Plan {
+        QPoint firstStep;  // (0, 0) 表示原地等待
+        int steps = 0;     // 到达安全位置要几步
+        quint64 departure = 0;  // 第一步开始的定时器时间
+        quint64 arrival = 0;    // 到达时的定时器时间
+        QPoint moves[HORIZON_STEPS];  // 每一步的位移，前 steps 个有效，(0, 0) 表示这一步原地等待
+    };
+
+    // now 是从 start 出发的定时器时间；passable(x, y) 决定位置能否停留
+    // windowAt(col, row) 返回方格的火焰时间窗（DangerTimeline::Window）
+    // score(x, y) 给终点打分（比如离危险区的距离），越大越好
+    // 视野内没有能活下来的路线时返回 false
+    template <typename Passable, typename WindowAt, typename Score>
+    bool plan(const QPoint &start, quint64 now, Passable passable, WindowAt windowAt, Score score, Plan &result);
+
+private:
+    enum : int {
+        RADIUS = HORIZON_STEPS,
+        SIDE = 2 * RADIUS + 1,
+        LAYER = SIDE * SIDE,
+        STATES = LAYER * (HORIZON_STEPS + 1)
+    };
+
+    SearchWorkspace m_search;  // 节点是时空状态，每个状态最多入队一次，按层推进
+
+    static const QPoint MOVES[5];
+
+    // 身体从 from 走到 to（或停在原地）的这段时间里，压到的方格都不起火
+    template <typename WindowAt>
+    static bool stepIsSafe(const QPoint &from, const QPoint &to, quint64 lo, quint64 hi, WindowAt &windowAt);
+    // 停在 pos 之后再也不会被火焰碰到
+    template <typename WindowAt>
+    static bool restsSafely(const QPoint &pos, quint64 tick, WindowAt &windowAt);
+    void trace(int state, Plan &result) const;  // 从终点回溯出每一步
+};
+
+template <typename Passable, typename WindowAt, typename Score>
+bool EscapePlanner::plan(const QPoint &start, quint64 now, Passable passable, WindowAt windowAt, Score score, Plan &result)
+{
+    m_search.begin(STATES);
+    auto stateOf = [&start](const QPoint &pos, int layer) {
+        return layer * LAYER + (pos.y() - start.y() + RADIUS) * SIDE + (pos.x() - start.x() + RADIUS);
+    };
+    auto pointOf = [&start](int state) {
+        const int local = state % LAYER;
+        return QPoint(start.x() + local % SIDE - RADIUS, start.y() + local / SIDE - RADIUS);
+    };
+
+    const int first = stateOf(start, 0);
+    m_search.visit(first, first);
+
+    // 状态只会从第 k 层走到第 k+1 层，队列天然按到达时间排序，第一个安全状态所在的层就是最快的
+    // 这一层剩下的状态也看完，从中挑评分最高的终点
+    int bestState = -1;
+    int bestScore = 0;
+    while (!m_search.isEmpty()) {
+        const int state = m_search.pop();
+        const int layer = state / LAYER;
+        if (bestState >= 0 && layer > bestState / LAYER) break;
+        const QPoint pos = pointOf(state);
+        const quint64 tick = now + quint64(layer) * GameConstants::MOVE_STEP_TICKS;
+        if (restsSafely(pos, tick, windowAt)) {
+            const int value = score(pos.x(), pos.y());
+            if (bestState < 0 || value > bestScore) {
+                bestState = state;
+                bestScore = value;
+            }
+            continue;
+        }
+        if (bestState >= 0 || layer == HORIZON_STEPS) continue;
+
+        // 走这一步时身体所在的 tick 区间（炸弹在移动之后结算）
+        const quint64 lo = tick + 1;
+        const quint64 hi = tick + GameConstants::MOVE_STEP_TICKS;
+        for (const QPoint &d : MOVES) {
+            const QPoint next = pos + d;
+            if (!passable(next.x(), next.y())) continue;
+            if (!stepIsSafe(pos, next, lo, hi, windowAt)) continue;
+            m_search.visit(stateOf(next, layer + 1), state);
+        }
+    }
+    if (bestState < 0) return false;
+
+    const int layer = bestState / LAYER;
+    trace(bestState, result);
+    result.steps = layer;
+    result.departure = now;
+    result.arrival = now + quint64(layer) * GameConstants::MOVE_STEP_TICKS;
+    return true;
+}
+
+template <typename WindowAt>
+bool EscapePlanner::stepIsSafe(const QPoint &from, const QPoint &to, quint64 lo, quint64 hi, WindowAt &windowAt)
+{
+    const int left = TileMap::cellOf(qMin(from.x(), to.x()));
+    const int right = TileMap::cellOf(qMax(from.x(), to.x()) + GameConstants::BLOCK_SIZE - 1);
+    const int top = TileMap::cellOf(qMin(from.y(), to.y()));
+    const int bottom = TileMap::cellOf(qMax(from.y(), to.y()) + GameConstants::BLOCK_SIZE - 1);
+    for (int row = top; row <= bottom; ++row) {
+        for (int col = left; col <= right; ++col) {
+            const DangerTimeline::Window window = windowAt(col, row);
+            if (window.start <= hi && window.end > lo) return false;
+        }
+    }
+    return true;
+}
+
+template <typename WindowAt>
+bool EscapePlanner::restsSafely(const QPoint &pos, quint64 tick, WindowAt &windowAt)
+{
+    const int left = TileMap::cellOf(pos.x());
+    const int right = TileMap::cellOf(pos.x() + GameConstants::BLOCK_SIZE - 1);
+    const int top = TileMap::cellOf(pos.y());
+    const int bottom = TileMap::cellOf(pos.y() + GameConstants::BLOCK_SIZE - 1);
+    for (int row = top; row <= bottom; ++row) {
+        for (int col = left; col <= right; ++col) {
+            const DangerTimeline::Window window = windowAt(col, row);
+            if (!window.isEmpty() && window.end > tick + 1) return false;
+        }
+    }
+    return true;
+}
+
+#endif // ESCAPEPLANNER_H
@@ -1,20 +1,80 @@
 #include "gamebotmanager.h"
 #include "gameengine.h"
 #include "player.h"
-#include "block.h"
 #include "bomb.h"
-#include <QGraphicsScene>
 #include <QRandomGenerator>
-#include <QBrush>
-#include <QPen>
 #include <cmath>
 #include <limits>
-#include <queue>
+
+namespace {
+// 未来危险的视野：从十字中心走出火焰最多要走 BOMB_RANGE + 1 格，按每次决策一个逻辑单位估算
+// （比实际移动节奏慢一倍，躲得早一些），再留一次决策的延迟。起火时间比这更远的炸弹暂时不用躲
+const int ESCAPE_TICKS = (GameConstants::BOMB_RANGE + 1) * GameConstants::BLOCK_SIZE
+                         * GameConstants::BOT_THINK_TICKS + GameConstants::BOT_THINK_TICKS;
+
+// 逃生落脚点预约多久：一颗新炸弹从放下到火焰熄灭
+const int ESCAPE_HOLD_TICKS = GameConstants::BOMB_FUSE_TICKS + GameConstants::EXPLOSION_TICKS;
+
+// 机器人沿路线走完一格要几个 tick，用来估计路线上每一格的经过时间
+const int CELL_MOVE_TICKS = GameConstants::BLOCK_SIZE * GameConstants::MOVE_STEP_TICKS;
+
+// 口袋（堵住一个割点就出不去的一侧）不超过这么多格算小：出口被炸弹封住后，
+// 里面躲不出火焰加上跟进的下一颗炸弹
+const int SMALL_POCKET_CELLS = 2 * GameConstants::BOMB_RANGE + 1;
+
+// 方格图上的四个方向
+const QPoint CELL_STEPS[] = { QPoint(1, 0), QPoint(-1, 0), QPoint(0, 1), QPoint(0, -1) };
+
+// 身体压得最多的那一格（方格坐标）
+QPoint centerCell(const QPoint &pos)
+{
+    return QPoint(TileMap::cellOf(pos.x() + GameConstants::BLOCK_SIZE / 2),
+                  TileMap::cellOf(pos.y() + GameConstants::BLOCK_SIZE / 2));
+}
+
+// 位置 (x, y) 能否停留：脚下的炸弹挡不住自己，standing 压着的方格允许离开，但不能走上别的炸弹
+bool passableFrom(const WalkabilityMap &walkability, const QRect &standing, int x, int y)
+{
+    if (walkability.isWalkable(x, y)) return true;
+    if (!walkability.isFreeOfBlocks(x, y)) return false;
+    return TileMap::cellOf(x) <= standing.right() && TileMap::cellOf(x + GameConstants::BLOCK_SIZE - 1) >= standing.left()
+           && TileMap::cellOf(y) <= standing.bottom() && TileMap::cellOf(y + GameConstants::BLOCK_SIZE - 1) >= standing.top();
+}
+}
 
 GameBotManager::GameBotManager(GameEngine *engine)
     : QObject(engine)
     , m_engine(engine)
 {
+    m_reservations.reset(GameConstants::MAP_GRID_COUNT, GameConstants::MAP_GRID_COUNT);
+
+    // 地图事件只作废受影响的路线
+    connect(engine, &GameEngine::blockDestroyed, this, [this](int col, int row) {
+        invalidateOpening(col, row);
+    });
+    connect(engine, &GameEngine::bombPlaced, this, [this](Bomb *bomb) {
+        invalidateBlast(bomb->blast());
+        invalidateEscapes(bomb);
+    });
+    connect(engine, &GameEngine::bombRemoved, this, [this](Bomb *bomb) {
+        BlastIndex::forEachCell(bomb->blast(), [this](int col, int row) {
+            invalidateOpening(col, row);
+        });
+    });
+    // 占用层跟着玩家和机器人换格的事件更新
+    connect(engine, &GameEngine::playerAdded, this, [this](Player *player) {
+        m_reservations.addBody(player->centerCell());
+        connect(player, &Player::cellChanged, this, [this, player](const QPoint &from, const QPoint &to) {
+            m_reservations.removeBody(from);
+            m_reservations.addBody(to);
+            invalidateTarget(player);
+        });
+    });
+    connect(engine, &GameEngine::playerRemoved, this, [this](Player *player) {
+        m_reservations.removeBody(player->centerCell());
+        if (player->isBot()) m_reservations.release(player->handle().index);
+        invalidateTarget(player);
+    });
 }
 
 GameBotManager::~GameBotManager()
@@ -31,33 +91,27 @@ void GameBotManager::spawnBots()
     int w = m_engine->mapWidth();
     int h = m_engine->mapHeight();
     QVector<QPoint> spawnCells = {
-        QPoint(w - Block::SIZE_UNITS * 2, Block::SIZE_UNITS),
-        QPoint(Block::SIZE_UNITS, h - Block::SIZE_UNITS * 2),
-        QPoint(w - Block::SIZE_UNITS * 2, h - Block::SIZE_UNITS * 2)
+        QPoint(w - GameConstants::BLOCK_SIZE * 2, GameConstants::BLOCK_SIZE),
+        QPoint(GameConstants::BLOCK_SIZE, h - GameConstants::BLOCK_SIZE * 2),
+        QPoint(w - GameConstants::BLOCK_SIZE * 2, h - GameConstants::BLOCK_SIZE * 2)
     };
 
     for (const QPoint &cell : spawnCells) {
         if (!isCellWalkable(cell.x(), cell.y())) continue;
-        Player *bot = new Player(cell.x(), cell.y());
-        bot->setBrush(QBrush(Qt::darkGreen));
-        bot->setPen(QPen(Qt::black, 1));
-        bot->setZValue(5); // Bot 层级高于炸弹
-        if (m_engine->scene()) {
-            m_engine->scene()->addItem(bot);
-        }
-        m_bots.append(bot);
+        Player *bot = new Player(cell.x(), cell.y(), true);
+        bot->setHandle(m_bots.insert(bot));
+        emit botAdded(bot);
     }
 }
 
 void GameBotManager::clearBots()
 {
-    for (Player *bot : m_bots) {
-        if (m_engine && m_engine->scene()) {
-            m_engine->scene()->removeItem(bot);
-        }
+    for (Player *bot : m_bots.values()) {
+        emit botRemoved(bot);
         delete bot;
     }
     m_bots.clear();
+    m_agents.clear();
 }
 
 void GameBotManager::updateBots()
@@ -67,59 +121,55 @@ void GameBotManager::updateBots()
     if (!player) return;
 
     // 计算当前和未来的危险区域
-    QSet<QPoint> currentDanger = computeDangerCells();
-    QSet<QPoint> futureDanger = computeFutureDangerCells(2); // 预测2步后的危险区域
-    QSet<QPoint> allDanger = currentDanger;
-    allDanger.unite(futureDanger);
+    // 按危险时间线：下次决策前就会起火的是当前危险，来不及逃出的是未来危险
+    // 两张都是逻辑单位位图，合并只是几次整字或运算
+    computeDanger(GameConstants::BOT_THINK_TICKS, m_burning);
+    computeDanger(ESCAPE_TICKS, m_danger);
+    m_danger |= m_burning;
     
-    QPoint playerCell = snapPlayerCell(player);
-
     // 收集所有可攻击的目标（玩家和其他机器人）
     QVector<Player*> allTargets;
     allTargets.append(player); // 添加人类玩家作为目标
-    for (Player *bot : m_bots) {
+    for (Player *bot : m_bots.values()) {
         if (bot && bot != player) {
             allTargets.append(bot); // 添加其他机器人作为目标
         }
     }
 
-    for (Player *bot : m_bots) {
+    // 所有机器人共用的距离场：每次决策作废一次，第一次用到时才算
+    resetSharedFields();
+
+    for (Player *bot : m_bots.values()) {
         if (!bot) continue;
         QPoint botCell = snapPlayerCell(bot);
-
-        // 1) 紧急躲避：立即危险
-        if (currentDanger.contains(botCell)) {
-            QPoint escapeStep;
-            if (findEscapeRoute(botCell, allDanger, escapeStep)) {
-                if (escapeStep == QPoint(1,0)) bot->moveRight();
-                else if (escapeStep == QPoint(-1,0)) bot->moveLeft();
-                else if (escapeStep == QPoint(0,1)) bot->moveDown();
-                else if (escapeStep == QPoint(0,-1)) bot->moveUp();
+        BotAgent &agent = agentOf(bot);
+
+        // 1) 紧急躲避 / 2) 预测性躲避：站在会起火的方格上时按引信时间规划最快的逃生路线
+        // 时间还宽裕就先做别的；本次和下次决策各可能多走一步，所以留两次决策的余量
+        // 逃生路线刚被打断的不等：新炸弹可能正在封住剩下的出路
+        const int flameIn = ticksUntilFlame(bot);
+        if (flameIn < 0) agent.resumeEscape = false;
+        EscapePlanner::Plan plan;
+        if (flameIn >= 0 && planEscape(bot, nullptr, plan)) {
+            const quint64 deadline = m_engine->timerNow() + quint64(flameIn);
+            if (agent.resumeEscape || plan.arrival + 2 * GameConstants::BOT_THINK_TICKS >= deadline) {
+                agent.actions.clear();
+                queueEscape(bot, agent, plan);
                 continue;
-            } else {
-                // 如果找不到明确的逃生路线，尝试任何可能的安全移动
-                if (findSafeStep(botCell, allDanger, escapeStep)) {
-                    if (escapeStep == QPoint(1,0)) bot->moveRight();
-                    else if (escapeStep == QPoint(-1,0)) bot->moveLeft();
-                    else if (escapeStep == QPoint(0,1)) bot->moveDown();
-                    else if (escapeStep == QPoint(0,-1)) bot->moveUp();
-                    continue;
-                }
             }
-        }
-
-        // 2) 预测性躲避：避开预测危险区域
-        if (futureDanger.contains(botCell)) {
-            QPoint safeStep;
-            if (findSafeStep(botCell, allDanger, safeStep)) {
-                if (safeStep == QPoint(1,0)) bot->moveRight();
-                else if (safeStep == QPoint(-1,0)) bot->moveLeft();
-                else if (safeStep == QPoint(0,1)) bot->moveDown();
-                else if (safeStep == QPoint(0,-1)) bot->moveUp();
+        } else if (isInDanger(botCell, m_danger)) {
+            // 视野内没有能活下来的路线，只能沿安全距离场尽量往外走
+            QPoint escapeStep;
+            if (safetyField().descend(botCell, escapeStep)) {
+                agent.actions.clear();
+                queueMoves(agent, escapeStep, 1);
                 continue;
             }
         }
 
+        // 上次排好的动作还没做完，不用重新决策
+        if (!agent.actions.isEmpty()) continue;
+
         // 3) 优先攻击最近的目标
         prioritizeTargets(allTargets, bot); // 按距离当前bot的远近排序目标
         
@@ -131,19 +181,21 @@ void GameBotManager::updateBots()
             QPoint targetCell = snapPlayerCell(target);
             int distance = std::abs(targetCell.x() - botCell.x()) + std::abs(targetCell.y() - botCell.y());
             
-            // 如果目标在爆炸范围内，考虑放置炸弹
-            if (distance <= Block::SIZE_UNITS * 2 && isPlayerInBombRange(bot, target)) {
-                if (shouldPlaceBomb(bot, allDanger)) {
-                    botPlaceBomb(bot);
-                    // 放置炸弹后逃离该区域
-                    moveBotAway(bot, allDanger);
+            // 如果目标在爆炸范围内，考虑放置炸弹；够不着但脚下放炸弹能把它关在小口袋里也放
+            if (distance <= GameConstants::BLOCK_SIZE * 2) {
+                const bool attack = isPlayerInBombRange(bot, target)
+                                        ? shouldPlaceBomb(bot)
+                                        : canTrapTarget(bot, targetCell) && isSafeBombSpot(bot);
+                // 放置炸弹并排好逃离的路线
+                if (attack && queueBombDrop(bot)) {
                     movedToAttack = true;
                     break;
                 }
             }
             
-            // 尝试接近目标
-            if (moveBotToward(bot, targetCell, allDanger)) {
+            // 尝试接近目标；并查集先排除根本走不到的目标，省掉一次寻路
+            if (!canReachPlayer(botCell, targetCell)) continue;
+            if (moveBotToward(bot, target)) {
                 movedToAttack = true;
                 break;
             }
@@ -155,238 +207,110 @@ void GameBotManager::updateBots()
 
         // 4) 如果没有合适的目标，去拆砖或探索
         QPoint brickStep;
-        if (findNearestBrickStep(botCell, allDanger, brickStep)) {
+        int brickUnits = 0;
+        if (pathStep(bot, nullptr, brickStep, brickUnits)) {
             // 检查是否靠近砖块并且可以放置炸弹开路
-            if (shouldPlaceBomb(bot, allDanger)) {
-                botPlaceBomb(bot);
-                // 放置炸弹后逃离该区域
-                moveBotAway(bot, allDanger);
+            if (shouldPlaceBomb(bot) && queueBombDrop(bot)) {
                 continue;
             }
             
-            if (brickStep == QPoint(1,0)) bot->moveRight();
-            else if (brickStep == QPoint(-1,0)) bot->moveLeft();
-            else if (brickStep == QPoint(0,1)) bot->moveDown();
-            else if (brickStep == QPoint(0,-1)) bot->moveUp();
+            queueMoves(agent, brickStep, brickUnits);
             continue;
         }
 
         // 5) 检查附近是否有可破坏的砖块，如果有则放置炸弹
-        if (hasDestructibleBrickInRange(bot, allDanger)) {
-            if (shouldPlaceBomb(bot, allDanger)) {
-                botPlaceBomb(bot);
-                // 放置炸弹后逃离该区域
-                moveBotAway(bot, allDanger);
+        if (hasDestructibleBrickInRange(bot)) {
+            if (shouldPlaceBomb(bot) && queueBombDrop(bot)) {
                 continue;
             }
         }
 
         // 6) 最后尝试接近玩家的贪心一步
         // 在接近玩家的过程中，也可以考虑放置炸弹
-        if (shouldPlaceBomb(bot, allDanger)) {
-            botPlaceBomb(bot);
-            // 放置炸弹后逃离该区域
-            moveBotAway(bot, allDanger);
+        if (shouldPlaceBomb(bot) && queueBombDrop(bot)) {
             continue;
         }
         
-        moveBotToward(bot, playerCell, allDanger);
+        moveBotToward(bot, player);
     }
 }
 
-QPoint GameBotManager::snapPlayerCell(Player *p) const
+void GameBotManager::runActions()
 {
-    int cx = static_cast<int>(std::round(p->x() / GameConstants::UNIT_SIZE));
-    int cy = static_cast<int>(std::round(p->y() / GameConstants::UNIT_SIZE));
-    return QPoint(cx, cy);
-}
-
-QSet<QPoint> GameBotManager::computeDangerCells() const
-{
-    QSet<QPoint> danger;
-    const QList<Bomb*> &bombs = m_engine->bombs();
-    for (Bomb *bomb : bombs) {
-        if (!bomb) continue;
-        QList<QPoint> cells = bomb->getExplosionPositions();
-        for (const QPoint &c : cells) {
-            danger.insert(c);
-        }
-    }
-    return danger;
-}
-
-bool GameBotManager::isCellWalkable(int x, int y) const
-{
-    return m_engine->isCellWalkable(x, y);
-}
-
-QVector<QPoint> GameBotManager::neighbors(const QPoint &cell) const
-{
-    QVector<QPoint> res;
-    QVector<QPoint> dirs = {QPoint(1,0), QPoint(-1,0), QPoint(0,1), QPoint(0,-1)};
-    // 使用与玩家一致的步长（1 个逻辑单位），避免因为整格步长而卡住
-    for (const QPoint &d : dirs) {
-        res.append(cell + d * GameConstants::LOGIC_UNIT);
-    }
-    return res;
-}
-
-bool GameBotManager::bfsNextStep(const QPoint &start, const QPoint &goal, const QSet<QPoint> &danger, QPoint &nextStep) const
-{
-    if (start == goal) {
-        nextStep = QPoint(0,0);
-        return true;
-    }
-    QSet<QPoint> visited;
-    std::queue<QPoint> q;
-    QHash<QPoint, QPoint> parent;
-    q.push(start);
-    visited.insert(start);
-
-    while (!q.empty()) {
-        QPoint cur = q.front(); q.pop();
-        for (const QPoint &nb : neighbors(cur)) {
-            if (visited.contains(nb)) continue;
-            if (!isCellWalkable(nb.x(), nb.y())) continue;
-            if (danger.contains(nb)) continue;
-            visited.insert(nb);
-            parent.insert(nb, cur);
-            if (nb == goal) {
-                // 回溯找下一步
-                QPoint step = nb;
-                while (parent.value(step) != start) {
-                    step = parent.value(step);
-                }
-                nextStep = step - start;
-                return true;
+    const quint64 now = m_engine->timerNow();
+    for (Player *bot : m_bots.values()) {
+        if (!bot) continue;
+        // 放炸弹会发出 bombPlaced，别的机器人的代理可能随之建立、m_agents 扩容，之后要重新取
+        BotAgent *agent = &agentOf(bot);
+        // 放炸弹不占移动时间，和后面的一步可以在同一个 tick 做；移动要等上一步走完
+        while (!agent->actions.isEmpty() && agent->actions.head().notBefore <= now) {
+            if (agent->actions.head().type == BotAction::BOMB) {
+                agent->actions.dequeue();
+                botPlaceBomb(bot);
+                agent = &agentOf(bot);
+                continue;
+            }
+            if (!bot->canMove()) break;
+            // 排队之后地图可能变了（新放的炸弹之类），走不过去就整队作废，下次决策重新规划
+            const QPoint next = bot->getPosition() + agent->actions.head().step;
+            if (!passableFrom(m_engine->walkability(), bot->coveredCells(), next.x(), next.y())) {
+                agent->resumeEscape = agent->escaping;
+                agent->escaping = false;
+                dropPath(*agent);
+                break;
             }
-            q.push(nb);
+            moveBotStep(bot, agent->actions.dequeue().step);
+            break;
         }
+        if (agent->actions.isEmpty()) agent->escaping = false;
     }
-    return false;
 }
 
-bool GameBotManager::canReachPlayer(const QPoint &botCell, const QPoint &playerCell, const QSet<QPoint> &danger) const
+QPoint GameBotManager::snapPlayerCell(Player *p) const
 {
-    QPoint step;
-    return bfsNextStep(botCell, playerCell, danger, step);
+    return p->getPosition();
 }
 
-bool GameBotManager::findSafeStep(const QPoint &botCell, const QSet<QPoint> &danger, QPoint &nextStep) const
+bool GameBotManager::isInDanger(const QPoint &pos, const GridBitset &danger) const
 {
-    // 多目标 BFS，目标是任意不在 danger 的格
-    QSet<QPoint> visited;
-    std::queue<QPoint> q;
-    QHash<QPoint, QPoint> parent;
-    q.push(botCell);
-    visited.insert(botCell);
-
-    while (!q.empty()) {
-        QPoint cur = q.front(); q.pop();
-        if (!danger.contains(cur)) {
-            if (cur == botCell) {
-                nextStep = QPoint(0,0);
-                return true;
-            }
-            QPoint step = cur;
-            while (parent.value(step) != botCell) {
-                step = parent.value(step);
-            }
-            nextStep = step - botCell;
-            return true;
-        }
-        for (const QPoint &nb : neighbors(cur)) {
-            if (visited.contains(nb)) continue;
-            if (!isCellWalkable(nb.x(), nb.y())) continue;
-            visited.insert(nb);
-            parent.insert(nb, cur);
-            q.push(nb);
-        }
-    }
-    return false;
+    // 危险位图已经按身体大小膨胀过：身体压着的任一方格危险，这个位置的位就是 1
+    return danger.test(pos.x(), pos.y());
 }
 
-QSet<QPoint> GameBotManager::computeFutureDangerCells(int timeSteps) const
+bool GameBotManager::isCellWalkable(int x, int y) const
 {
-    QSet<QPoint> futureDanger;
-    const QList<Bomb*> &bombs = m_engine->bombs();
-    
-    // 计算所有未爆炸的炸弹在timeSteps步后会爆炸的区域
-    for (Bomb *bomb : bombs) {
-        if (!bomb || bomb->isExploding()) continue;
-        
-        // 假设炸弹会在timeSteps步后爆炸，计算其影响范围
-        QList<QPoint> cells = bomb->getExplosionPositions();
-        for (const QPoint &c : cells) {
-            futureDanger.insert(c);
-        }
-    }
-    return futureDanger;
+    return m_engine->isCellWalkable(x, y);
 }
 
-bool GameBotManager::isCellInBombRange(const QPoint &cell) const
+bool GameBotManager::canReachPlayer(const QPoint &botCell, const QPoint &playerCell) const
 {
-    const QList<Bomb*> &bombs = m_engine->bombs();
-    for (Bomb *bomb : bombs) {
-        if (!bomb || bomb->isExploding()) continue;
-        
-        QList<QPoint> explosionPositions = bomb->getExplosionPositions();
-        if (explosionPositions.contains(cell)) {
-            return true;
-        }
-    }
-    return false;
+    // 地形连通性查并查集，区域里有炸弹时才会退回到区域内的小 BFS
+    return m_engine->regions().reachable(centerCell(botCell), centerCell(playerCell));
 }
 
-bool GameBotManager::findEscapeRoute(const QPoint &botCell, const QSet<QPoint> &danger, QPoint &nextStep) const
+void GameBotManager::computeDanger(int horizonTicks, GridBitset &danger) const
 {
-    // 使用更智能的逃生算法，优先选择远离炸弹的方向
-    QVector<QPoint> directions = {QPoint(1,0), QPoint(-1,0), QPoint(0,1), QPoint(0,-1)};
-    QVector<QPoint> safeOptions;
-    
-    // 检查所有相邻的可通行位置
-    for (const QPoint &dir : directions) {
-        QPoint nextPos = botCell + dir * GameConstants::LOGIC_UNIT;
-        if (isCellWalkable(nextPos.x(), nextPos.y()) && !danger.contains(nextPos)) {
-            safeOptions.append(dir);
-        }
-    }
-    
-    if (safeOptions.isEmpty()) {
-        return false;
-    }
-    
-    // 如果有多个安全选项，选择最远离当前危险的方向
-    if (safeOptions.size() > 1) {
-        // 计算每个方向的"安全值"（远离危险的程度）
-        QPoint bestDir = safeOptions[0];
-        int bestSafety = -1;
-        
-        for (const QPoint &dir : safeOptions) {
-            QPoint testPos = botCell + dir * GameConstants::LOGIC_UNIT;
-            int safety = 0;
-            
-            // 计算到最近危险点的距离
-            for (const QPoint &dangerPos : danger) {
-                int dist = std::abs(testPos.x() - dangerPos.x()) + std::abs(testPos.y() - dangerPos.y());
-                safety += dist; // 累加所有危险点的距离
-            }
-            
-            if (safety > bestSafety) {
-                bestSafety = safety;
-                bestDir = dir;
-            }
-        }
-        
-        nextStep = bestDir;
+    const int w = m_engine->mapWidth();
+    const int h = m_engine->mapHeight();
+    if (danger.width() != w || danger.height() != h) {
+        danger.resize(w, h);
     } else {
-        nextStep = safeOptions[0];
+        danger.clear();
     }
+    const quint64 now = m_engine->timerNow();
+    const quint64 horizon = now + quint64(horizonTicks);
     
-    return true;
+    // 时间线已经算好了每个方格最早的起火时间（含连锁），只取 horizonTicks 内会起火的
+    // 身体左上角落在方格周围 (2*BLOCK_SIZE-1)^2 的范围内就会压到这一格，整块按行写入
+    const int span = 2 * GameConstants::BLOCK_SIZE - 1;
+    m_engine->dangerTimeline().forEachWindow([&](int col, int row, const DangerTimeline::Window &window) {
+        if (window.end <= now || window.start > horizon) return;
+        danger.fillRect(col * GameConstants::BLOCK_SIZE - GameConstants::BLOCK_SIZE + 1,
+                        row * GameConstants::BLOCK_SIZE - GameConstants::BLOCK_SIZE + 1, span, span);
+    });
 }
 
-bool GameBotManager::shouldPlaceBomb(Player *bot, const QSet<QPoint> &danger) const
+bool GameBotManager::shouldPlaceBomb(Player *bot) const
 {
     if (!bot) return false;
     
@@ -394,17 +318,16 @@ bool GameBotManager::shouldPlaceBomb(Player *bot, const QSet<QPoint> &danger) co
     
     // 检查附近是否有可破坏的砖块或玩家/机器人
     bool hasTarget = false;
-    bool hasDestructibleBlock = false;
     
     // 检查爆炸范围内是否有可破坏的砖块（用于开路）
-    int bombRange = 1; // 默认炸弹范围为1个单位
+    const int bombRange = bot->bombRange();  // 火焰每个方向能走几格
     for (int i = 0; i <= bombRange; ++i) { // 检查包括当前位置在内的爆炸范围
         // 检查上下左右方向
         QPoint center(botCell.x(), botCell.y());
-        QPoint up(botCell.x(), botCell.y() - i * Block::SIZE_UNITS);
-        QPoint down(botCell.x(), botCell.y() + i * Block::SIZE_UNITS);
-        QPoint left(botCell.x() - i * Block::SIZE_UNITS, botCell.y());
-        QPoint right(botCell.x() + i * Block::SIZE_UNITS, botCell.y());
+        QPoint up(botCell.x(), botCell.y() - i * GameConstants::BLOCK_SIZE);
+        QPoint down(botCell.x(), botCell.y() + i * GameConstants::BLOCK_SIZE);
+        QPoint left(botCell.x() - i * GameConstants::BLOCK_SIZE, botCell.y());
+        QPoint right(botCell.x() + i * GameConstants::BLOCK_SIZE, botCell.y());
         
         QVector<QPoint> checkPositions;
         if (i == 0) {
@@ -415,15 +338,8 @@ bool GameBotManager::shouldPlaceBomb(Player *bot, const QSet<QPoint> &danger) co
         
         for (const QPoint &pos : checkPositions) {
             // 检查该位置是否有可破坏的砖块
-            const QList<Block*> &blocks = m_engine->blocks();
-            for (Block *block : blocks) {
-                if (block->isDestructible() && 
-                    static_cast<int>(block->x() / GameConstants::UNIT_SIZE) == pos.x() &&
-                    static_cast<int>(block->y() / GameConstants::UNIT_SIZE) == pos.y()) {
-                    hasDestructibleBlock = true;
-                    hasTarget = true; // 将可破坏砖块也视为目标
-                    break;
-                }
+            if (m_engine->tileMap().tileAtUnits(pos.x(), pos.y()) == TileMap::BRICK) {
+                hasTarget = true; // 将可破坏砖块也视为目标
             }
             
             // 检查该位置是否有玩家或机器人
@@ -433,7 +349,7 @@ bool GameBotManager::shouldPlaceBomb(Player *bot, const QSet<QPoint> &danger) co
                 break;
             }
             
-            for (Player *otherBot : m_bots) {
+            for (Player *otherBot : m_bots.values()) {
                 if (otherBot && otherBot != bot && snapPlayerCell(otherBot) == pos) {
                     hasTarget = true;
                     break;
@@ -442,108 +358,31 @@ bool GameBotManager::shouldPlaceBomb(Player *bot, const QSet<QPoint> &danger) co
         }
     }
     
-    // 检查放置炸弹后是否有逃生路线
-    QSet<QPoint> bombDanger = getBombDangerArea(botCell);
-    
-    // 检查是否能在放置炸弹后逃离
-    QPoint escapeStep;
-    QSet<QPoint> totalDanger = danger;
-    totalDanger.unite(bombDanger);
-    if (findSafeStep(botCell, totalDanger, escapeStep)) {
-        return hasTarget; // 如果有目标且能逃生，则放置炸弹
-    }
-    
-    // 如果机器人在可破坏砖块旁边，即使暂时没有安全的逃生路线，也可以考虑放置炸弹
-    // 因为机器人可能能够移动到安全位置后再引爆
-    if (hasDestructibleBlock) {
-        // 检查是否有任何可以移动的方向
-        QVector<QPoint> directions = {QPoint(1,0), QPoint(-1,0), QPoint(0,1), QPoint(0,-1)};
-        for (const QPoint &dir : directions) {
-            QPoint nextPos = botCell + dir * GameConstants::LOGIC_UNIT;
-            if (isCellWalkable(nextPos.x(), nextPos.y()) && !danger.contains(nextPos)) {
-                // 如果可以移动到安全位置，可以放置炸弹然后移动
-                return true;
-            }
-        }
-    }
-    
-    return false;
+    return hasTarget && isSafeBombSpot(bot);
+}
+
+bool GameBotManager::isSafeBombSpot(Player *bot) const
+{
+    // 放下炸弹之后能不能活着走出所有火焰（包括这颗）：整张表每次决策算一次，这里只查表
+    // 不在方格原点时身体还压着相邻方格，真正放下之前 queueBombDrop 会再用时空规划确认
+    const QPoint botCell = snapPlayerCell(bot);
+    return bombSpots(bot->bombRange()).isSafe(TileMap::cellOf(botCell.x()), TileMap::cellOf(botCell.y()));
 }
 
 bool GameBotManager::isPlayerInBombRange(Player *bot, Player *target) const
 {
     if (!bot || !target) return false;
     
+    // 在机器人所在方格放炸弹，火焰是否碰到目标压着的任一方格
     QPoint botCell = snapPlayerCell(bot);
-    QPoint targetCell = snapPlayerCell(target);
-    
-    // 检查目标是否在炸弹爆炸范围内（十字形范围）
-    int dx = std::abs(targetCell.x() - botCell.x());
-    int dy = std::abs(targetCell.y() - botCell.y());
-    
-    // 如果在同一行或同一列，且距离在爆炸范围内
-    if ((dx == 0 && dy <= Block::SIZE_UNITS) || 
-        (dy == 0 && dx <= Block::SIZE_UNITS)) {
-        // 检查中间路径是否畅通（没有墙阻挡）
-        int minX = std::min(botCell.x(), targetCell.x());
-        int maxX = std::max(botCell.x(), targetCell.x());
-        int minY = std::min(botCell.y(), targetCell.y());
-        int maxY = std::max(botCell.y(), targetCell.y());
-        
-        bool pathClear = true;
-        if (dx == 0) { // 同一列
-            for (int y = minY; y <= maxY; y += GameConstants::LOGIC_UNIT) {
-                if (y != botCell.y()) { // 跳过机器人自己的位置
-                    QPoint pos(botCell.x(), y);
-                    if (!isCellWalkable(pos.x(), pos.y()) && 
-                        !isCellInBombRange(pos)) { // 如果是不可通行的墙而非空路径
-                        // 检查是否是砖块
-                        bool isBrick = false;
-                        const QList<Block*> &blocks = m_engine->blocks();
-                        for (Block *block : blocks) {
-                            if (static_cast<int>(block->x() / GameConstants::UNIT_SIZE) == pos.x() &&
-                                static_cast<int>(block->y() / GameConstants::UNIT_SIZE) == pos.y() &&
-                                !block->isDestructible()) { // 是不可破坏的墙
-                                isBrick = true;
-                                break;
-                            }
-                        }
-                        if (isBrick) {
-                            pathClear = false;
-                            break;
-                        }
-                    }
-                }
-            }
-        } else if (dy == 0) { // 同一行
-            for (int x = minX; x <= maxX; x += GameConstants::LOGIC_UNIT) {
-                if (x != botCell.x()) { // 跳过机器人自己的位置
-                    QPoint pos(x, botCell.y());
-                    if (!isCellWalkable(pos.x(), pos.y()) && 
-                        !isCellInBombRange(pos)) {
-                        // 检查是否是砖块
-                        bool isBrick = false;
-                        const QList<Block*> &blocks = m_engine->blocks();
-                        for (Block *block : blocks) {
-                            if (static_cast<int>(block->x() / GameConstants::UNIT_SIZE) == pos.x() &&
-                                static_cast<int>(block->y() / GameConstants::UNIT_SIZE) == pos.y() &&
-                                !block->isDestructible()) { // 是不可破坏的墙
-                                isBrick = true;
-                                break;
-                            }
-                        }
-                        if (isBrick) {
-                            pathClear = false;
-                            break;
-                        }
-                    }
-                }
-            }
+    const BlastIndex::Blast blast = m_engine->blastIndex().blastAt(
+        TileMap::cellOf(botCell.x()), TileMap::cellOf(botCell.y()), bot->bombRange());
+    const QRect cells = target->coveredCells();
+    for (int row = cells.top(); row <= cells.bottom(); ++row) {
+        for (int col = cells.left(); col <= cells.right(); ++col) {
+            if (blast.reaches(col, row)) return true;
         }
-        
-        return pathClear;
     }
-    
     return false;
 }
 
@@ -551,165 +390,14 @@ bool GameBotManager::canTrapTarget(Player *bot, const QPoint &targetPos) const
 {
     if (!bot) return false;
     
-    QPoint botCell = snapPlayerCell(bot);
-    
-    // 检查是否可以通过放置炸弹困住目标
-    // 基本思路：检查目标周围是否有足够的障碍物，使得放置炸弹后目标无法逃脱
-    
-    // 获取目标周围的四个方向
-    QVector<QPoint> dirs = {QPoint(1,0), QPoint(-1,0), QPoint(0,1), QPoint(0,-1)};
-    int trappedDirections = 0;
-    
-    for (const QPoint &dir : dirs) {
-        QPoint adjacentPos = targetPos + dir * Block::SIZE_UNITS;
-        
-        // 检查这个方向是否被阻挡（墙壁、边界或其他不可通行区域）
-        if (!isCellWalkable(adjacentPos.x(), adjacentPos.y())) {
-            trappedDirections++;
-        } else {
-            // 检查是否在当前bot的炸弹爆炸范围内，如果在范围内则也可以视为被阻挡
-            int dx = std::abs(adjacentPos.x() - botCell.x());
-            int dy = std::abs(adjacentPos.y() - botCell.y());
-            
-            if ((dx == 0 && dy <= Block::SIZE_UNITS) || 
-                (dy == 0 && dx <= Block::SIZE_UNITS)) {
-                // 检查中间路径是否畅通
-                int minX = std::min(botCell.x(), adjacentPos.x());
-                int maxX = std::max(botCell.x(), adjacentPos.x());
-                int minY = std::min(botCell.y(), adjacentPos.y());
-                int maxY = std::max(botCell.y(), adjacentPos.y());
-                
-                bool pathClear = true;
-                if (dx == 0) { // 同一列
-                    for (int y = minY; y <= maxY; y += GameConstants::LOGIC_UNIT) {
-                        if (y != botCell.y()) {
-                            QPoint pos(botCell.x(), y);
-                            if (!isCellWalkable(pos.x(), pos.y())) {
-                                pathClear = false;
-                                break;
-                            }
-                        }
-                    }
-                } else if (dy == 0) { // 同一行
-                    for (int x = minX; x <= maxX; x += GameConstants::LOGIC_UNIT) {
-                        if (x != botCell.x()) {
-                            QPoint pos(x, botCell.y());
-                            if (!isCellWalkable(pos.x(), pos.y())) {
-                                pathClear = false;
-                                break;
-                            }
-                        }
-                    }
-                }
-                
-                if (pathClear) {
-                    // 这个方向将被炸弹覆盖，所以也被视为被困住
-                    trappedDirections++;
-                }
-            }
-        }
-    }
-    
-    // 如果超过2个方向被阻挡，则认为可能困住目标
-    return trappedDirections >= 3;
-}
-
-QSet<QPoint> GameBotManager::getBombDangerArea(const QPoint &bombPos) const
-{
-    QSet<QPoint> dangerArea;
-    QPoint bombCell(bombPos.x() / Block::SIZE_UNITS * Block::SIZE_UNITS, 
-                    bombPos.y() / Block::SIZE_UNITS * Block::SIZE_UNITS);
-    
-    // 添加炸弹中心位置
-    dangerArea.insert(bombCell);
-    
-    // 向四个方向扩展爆炸范围
-    for (int i = 1; i <= 1; ++i) { // 默认爆炸范围为1个单位
-        QPoint up(bombCell.x(), bombCell.y() - i * Block::SIZE_UNITS);
-        QPoint down(bombCell.x(), bombCell.y() + i * Block::SIZE_UNITS);
-        QPoint left(bombCell.x() - i * Block::SIZE_UNITS, bombCell.y());
-        QPoint right(bombCell.x() + i * Block::SIZE_UNITS, bombCell.y());
-        
-        // 检查向上方向
-        if (isCellWalkable(up.x(), up.y())) {
-            dangerArea.insert(up);
-        } else {
-            // 如果遇到不可通行的障碍物（墙或砖块），停止扩展
-            const QList<Block*> &blocks = m_engine->blocks();
-            bool isWall = true;
-            for (Block *block : blocks) {
-                if (static_cast<int>(block->x() / GameConstants::UNIT_SIZE) == up.x() &&
-                    static_cast<int>(block->y() / GameConstants::UNIT_SIZE) == up.y()) {
-                    if (block->isDestructible()) {
-                        // 可破坏的砖块，仍会爆炸到那里
-                        dangerArea.insert(up);
-                    }
-                    isWall = false;
-                    break;
-                }
-            }
-            if (isWall) break; // 如果是不可破坏的墙，停止扩展
-        }
-        
-        // 检查向下方向
-        if (isCellWalkable(down.x(), down.y())) {
-            dangerArea.insert(down);
-        } else {
-            const QList<Block*> &blocks = m_engine->blocks();
-            bool isWall = true;
-            for (Block *block : blocks) {
-                if (static_cast<int>(block->x() / GameConstants::UNIT_SIZE) == down.x() &&
-                    static_cast<int>(block->y() / GameConstants::UNIT_SIZE) == down.y()) {
-                    if (block->isDestructible()) {
-                        dangerArea.insert(down);
-                    }
-                    isWall = false;
-                    break;
-                }
-            }
-            if (isWall) break;
-        }
-        
-        // 检查向左方向
-        if (isCellWalkable(left.x(), left.y())) {
-            dangerArea.insert(left);
-        } else {
-            const QList<Block*> &blocks = m_engine->blocks();
-            bool isWall = true;
-            for (Block *block : blocks) {
-                if (static_cast<int>(block->x() / GameConstants::UNIT_SIZE) == left.x() &&
-                    static_cast<int>(block->y() / GameConstants::UNIT_SIZE) == left.y()) {
-                    if (block->isDestructible()) {
-                        dangerArea.insert(left);
-                    }
-                    isWall = false;
-                    break;
-                }
-            }
-            if (isWall) break;
-        }
-        
-        // 检查向右方向
-        if (isCellWalkable(right.x(), right.y())) {
-            dangerArea.insert(right);
-        } else {
-            const QList<Block*> &blocks = m_engine->blocks();
-            bool isWall = true;
-            for (Block *block : blocks) {
-                if (static_cast<int>(block->x() / GameConstants::UNIT_SIZE) == right.x() &&
-                    static_cast<int>(block->y() / GameConstants::UNIT_SIZE) == right.y()) {
-                    if (block->isDestructible()) {
-                        dangerArea.insert(right);
-                    }
-                    isWall = false;
-                    break;
-                }
-            }
-            if (isWall) break;
-        }
-    }
-    
-    return dangerArea;
+    // 机器人脚下是割点，并且堵住它之后目标被关在很小的那一侧：在这里放炸弹就封死了目标的出路
+    const QPoint botCell = snapPlayerCell(bot);
+    const QPoint cut(TileMap::cellOf(botCell.x()), TileMap::cellOf(botCell.y()));
+    const QPoint target(TileMap::cellOf(targetPos.x()), TileMap::cellOf(targetPos.y()));
+    const MapTopology &topology = m_engine->topology();
+    if (!topology.isArticulation(cut.x(), cut.y())) return false;
+    const int side = topology.sideSize(cut, target);
+    return side > 0 && side <= SMALL_POCKET_CELLS;
 }
 
 void GameBotManager::prioritizeTargets(QVector<Player*> &targets, Player *currentBot) const
@@ -729,135 +417,557 @@ void GameBotManager::prioritizeTargets(QVector<Player*> &targets, Player *curren
     });
 }
 
-QList<Player*> GameBotManager::getBots() const
+void GameBotManager::removeBot(Player *bot)
+{
+    if (bot && m_bots.remove(bot->handle())) {
+        emit botRemoved(bot);
+    }
+}
+
+bool GameBotManager::moveBotToward(Player *bot, Player *target)
+{
+    // 沿目标路线走一步；已经到达或到不了时返回 false，交给下一个目标
+    QPoint step;
+    int units = 0;
+    if (!pathStep(bot, target, step, units) || step.isNull()) {
+        return false;
+    }
+    queueMoves(agentOf(bot), step, units);
+    return true;
+}
+
+bool GameBotManager::routeStep(Player *bot, const CellRouter &route, QPoint &step) const
+{
+    // 不在方格原点时的局部细化按逻辑单位检查，同样避开危险区
+    return route.nextStep(snapPlayerCell(bot), [this](int x, int y) {
+        return isCellWalkable(x, y) && !isInDanger(QPoint(x, y), m_danger);
+    }, step);
+}
+
+bool GameBotManager::isCellRoutable(int col, int row, const GridBitset &danger) const
 {
-    QList<Player*> result;
-    for (Player *bot : m_bots) {
-        if (bot) {
-            result.append(bot);
+    // 方格图上的一格：空地、没有未爆炸的炸弹、不在危险区（站在方格原点只压这一格）
+    return m_engine->tileMap().tileAt(col, row) == TileMap::EMPTY
+           && !m_engine->walkability().hasBomb(col, row)
+           && !danger.test(col * GameConstants::BLOCK_SIZE, row * GameConstants::BLOCK_SIZE);
+}
+
+void GameBotManager::moveBotStep(Player *bot, const QPoint &step)
+{
+    if (step == QPoint(1,0)) bot->moveRight();
+    else if (step == QPoint(-1,0)) bot->moveLeft();
+    else if (step == QPoint(0,1)) bot->moveDown();
+    else if (step == QPoint(0,-1)) bot->moveUp();
+}
+
+void GameBotManager::resetSharedFields()
+{
+    m_safetyDirty = true;
+    m_hazardDirty = true;
+    m_brickRouteDirty = true;
+    m_bombSpotsDirty = true;
+    m_targetRouteOwners.resize(0);
+}
+
+const DistanceField& GameBotManager::safetyField() const
+{
+    if (!m_safetyDirty) return m_safetyField;
+    m_safetyDirty = false;
+
+    // 安全距离场：源点是所有不在危险区的可通行位置，危险区本身也可以穿过
+    // 刚放下的炸弹压在机器人脚下，所以这里只把墙和砖块当障碍；马上就会起火的地方不能穿过
+    const int w = m_engine->mapWidth();
+    const int h = m_engine->mapHeight();
+    // 源点 = 可通行位图去掉危险位图，整字运算后只遍历置位的位置
+    const WalkabilityMap &walkability = m_engine->walkability();
+    m_scratch = walkability.walkable();
+    m_scratch.subtract(m_danger);
+    m_fieldSources.resize(0);
+    m_scratch.forEachSet([this](int x, int y) {
+        m_fieldSources.append(QPoint(x, y));
+    });
+    m_safetyField.compute(w, h, m_fieldSources, [this, &walkability](int x, int y) {
+        return walkability.isFreeOfBlocks(x, y) && !isInDanger(QPoint(x, y), m_burning);
+    });
+    return m_safetyField;
+}
+
+const DistanceField& GameBotManager::hazardField() const
+{
+    if (!m_hazardDirty) return m_hazardField;
+    m_hazardDirty = false;
+
+    // 危险距离变换：每个位置到最近危险位置要走几步（绕开墙和砖块），逃生时用来给终点打分
+    // 源点是身体会压到危险方格的所有位置，也就是危险位图里置位的位置
+    const WalkabilityMap &walkability = m_engine->walkability();
+    m_fieldSources.resize(0);
+    m_danger.forEachSet([this](int x, int y) {
+        m_fieldSources.append(QPoint(x, y));
+    });
+    m_hazardField.compute(m_engine->mapWidth(), m_engine->mapHeight(), m_fieldSources, [&walkability](int x, int y) {
+        return walkability.isFreeOfBlocks(x, y);
+    });
+    return m_hazardField;
+}
+
+const CellRouter& GameBotManager::brickRoute() const
+{
+    if (!m_brickRouteDirty) return m_brickRoute;
+    m_brickRouteDirty = false;
+
+    // 拆砖路线：源点是紧挨砖块的方格（在这里放炸弹能炸到砖块），只在方格图上算
+    const TileMap &tiles = m_engine->tileMap();
+    auto routable = [this](int col, int row) {
+        return isCellRoutable(col, row, m_danger);
+    };
+    m_fieldSources.resize(0);
+    if (tiles.brickCount() > 0) {
+        for (int row = 0; row < tiles.rows(); ++row) {
+            for (int col = 0; col < tiles.columns(); ++col) {
+                if (!routable(col, row)) continue;
+                if (tiles.tileAt(col + 1, row) == TileMap::BRICK || tiles.tileAt(col - 1, row) == TileMap::BRICK ||
+                    tiles.tileAt(col, row + 1) == TileMap::BRICK || tiles.tileAt(col, row - 1) == TileMap::BRICK) {
+                    m_fieldSources.append(QPoint(col, row));
+                }
+            }
         }
     }
-    return result;
+    m_brickRoute.compute(tiles.columns(), tiles.rows(), m_fieldSources, routable);
+    return m_brickRoute;
 }
 
-void GameBotManager::removeBot(Player *bot)
+const CellRouter& GameBotManager::targetRoute(Player *target)
 {
-    if (bot) {
-        m_bots.removeAll(bot);
+    // 同一次决策里每个目标只算一次，之后所有机器人直接查表
+    const int cached = m_targetRouteOwners.indexOf(target);
+    if (cached >= 0) return m_targetRoutes[cached];
+
+    const int slot = m_targetRouteOwners.size();
+    m_targetRouteOwners.append(target);
+    if (m_targetRoutes.size() <= slot) {
+        m_targetRoutes.resize(slot + 1);
     }
+    // 目标压得最多的那一格作为源点
+    m_fieldSources.resize(0);
+    m_fieldSources.append(target->centerCell());
+    const TileMap &tiles = m_engine->tileMap();
+    m_targetRoutes[slot].compute(tiles.columns(), tiles.rows(), m_fieldSources, [this](int col, int row) {
+        return isCellRoutable(col, row, m_danger);
+    });
+    return m_targetRoutes[slot];
 }
 
-bool GameBotManager::findNearestBrickStep(const QPoint &botCell, const QSet<QPoint> &danger, QPoint &nextStep) const
+GameBotManager::BotAgent& GameBotManager::agentOf(Player *bot)
 {
-    // 先收集所有砖块格
-    QList<QPoint> bricks;
-    const QList<Block*> &blocks = m_engine->blocks();
-    for (Block *b : blocks) {
-        if (!b->isDestructible()) continue;
-        QPoint bc(static_cast<int>(b->x() / GameConstants::UNIT_SIZE),
-                  static_cast<int>(b->y() / GameConstants::UNIT_SIZE));
-        bricks.append(bc);
+    const EntityHandle handle = bot->handle();
+    if (m_agents.size() <= handle.index) {
+        m_agents.resize(handle.index + 1);
+    }
+    BotAgent &agent = m_agents[handle.index];
+    if (agent.owner != handle) {
+        // 槽位被新的机器人复用，旧路线和动作都不算数
+        agent.owner = handle;
+        agent.path.kind = BotPath::NONE;
+        agent.actions.clear();
+        agent.escaping = false;
+        agent.plannedBomb = QPoint(-1, -1);
+        agent.resumeEscape = false;
     }
-    if (bricks.isEmpty()) return false;
+    return agent;
+}
 
-    // 多目标 BFS：从bot出发，遇到任一砖块即返回
-    QSet<QPoint> targets = QSet<QPoint>(bricks.begin(), bricks.end());
-    QSet<QPoint> visited;
-    std::queue<QPoint> q;
-    QHash<QPoint, QPoint> parent;
-    q.push(botCell);
-    visited.insert(botCell);
+bool GameBotManager::pathStep(Player *bot, Player *target, QPoint &step, int &units)
+{
+    const BotPath::Kind kind = target ? BotPath::TARGET : BotPath::BRICK;
+    const QPoint pos = snapPlayerCell(bot);
+    BotPath &path = agentOf(bot).path;
+    if (path.kind == kind && path.target == target && followPath(path, pos, step, units)) {
+        return true;
+    }
 
-    while (!q.empty()) {
-        QPoint cur = q.front(); q.pop();
-        if (targets.contains(cur)) {
-            // 回溯找下一步
-            if (cur == botCell) {
-                nextStep = QPoint(0,0);
-                return true;
-            }
-            QPoint step = cur;
-            while (parent.value(step) != botCell) {
-                step = parent.value(step);
-            }
-            nextStep = step - botCell;
-            return true;
+    // 缓存没有或者已经作废：正好在方格原点上时把整条路线记下来，一次排到下一个方格原点；
+    // 不在原点上时查距离场走一步
+    // 追目标是点到点的远距离寻路，在原点上直接跳点搜索，不用为这个目标整张图算距离场；
+    // 拆砖要找最近的一块，只能沿多源距离场走
+    path.kind = BotPath::NONE;
+    const QPoint cell(TileMap::cellOf(pos.x()), TileMap::cellOf(pos.y()));
+    const bool onOrigin = pos.x() % GameConstants::BLOCK_SIZE == 0 && pos.y() % GameConstants::BLOCK_SIZE == 0;
+    if (target && onOrigin) {
+        if (storeChase(bot, path, target, cell) && followPath(path, pos, step, units)) return true;
+        path.kind = BotPath::NONE;
+        return false;
+    }
+    const CellRouter &route = target ? targetRoute(target) : brickRoute();
+    if (onOrigin) {
+        storePath(bot, path, kind, target, route, cell);
+        if (path.kind != BotPath::NONE && followPath(path, pos, step, units)) return true;
+        path.kind = BotPath::NONE;
+    }
+    units = 1;
+    return routeStep(bot, route, step);
+}
+
+bool GameBotManager::followPath(BotPath &path, const QPoint &pos, QPoint &step, int &units) const
+{
+    // 走到终点后原地不动，直到有事件让路线作废
+    const QPoint last = path.cells.last() * GameConstants::BLOCK_SIZE;
+    if (pos == last) {
+        step = QPoint(0, 0);
+        units = 0;
+        return true;
+    }
+    while (path.next < path.cells.size()) {
+        const QPoint to = path.cells[path.next] * GameConstants::BLOCK_SIZE;
+        if (pos == to) {
+            ++path.next;
+            continue;
         }
-        for (const QPoint &nb : neighbors(cur)) {
-            if (visited.contains(nb)) continue;
-            if (!isCellWalkable(nb.x(), nb.y())) continue;
-            if (danger.contains(nb)) continue;
-            visited.insert(nb);
-            parent.insert(nb, cur);
-            q.push(nb);
+        // 相邻两格的原点在同一行或同一列上，机器人必须还在这一段上，被挤开了就重新规划
+        const QPoint from = path.cells[path.next - 1] * GameConstants::BLOCK_SIZE;
+        const bool onRow = pos.y() == to.y() && from.y() == to.y()
+                           && pos.x() >= qMin(from.x(), to.x()) && pos.x() <= qMax(from.x(), to.x());
+        const bool onColumn = pos.x() == to.x() && from.x() == to.x()
+                              && pos.y() >= qMin(from.y(), to.y()) && pos.y() <= qMax(from.y(), to.y());
+        if (!onRow && !onColumn) return false;
+        step = QPoint(qBound(-1, to.x() - pos.x(), 1), qBound(-1, to.y() - pos.y(), 1));
+        // 一直走到下一个方格原点；路线规划之后才进入预警范围的火焰没有事件通知，排之前逐步再看一眼
+        const int remaining = qAbs(to.x() - pos.x()) + qAbs(to.y() - pos.y());
+        QPoint next = pos;
+        for (units = 0; units < remaining; ++units) {
+            next += step;
+            if (!isCellWalkable(next.x(), next.y()) || isInDanger(next, m_danger)) break;
         }
+        return units > 0;
     }
     return false;
 }
 
-bool GameBotManager::moveBotToward(Player *bot, const QPoint &target, const QSet<QPoint> &danger)
+void GameBotManager::storePath(Player *bot, BotPath &path, BotPath::Kind kind, Player *target,
+                               const CellRouter &route, const QPoint &cell)
 {
-    QPoint botCell = snapPlayerCell(bot);
-    int dx = target.x() - botCell.x();
-    int dy = target.y() - botCell.y();
-    QPoint step(
-        (dx == 0) ? 0 : (dx > 0 ? 1 : -1),
-        (dy == 0) ? 0 : (dy > 0 ? 1 : -1)
-    );
-
-    // 优先大轴向
-    QVector<QPoint> options;
-    if (std::abs(dx) >= std::abs(dy)) {
-        options << QPoint(step.x(), 0) << QPoint(0, step.y());
+    const DistanceField &cells = route.cells();
+    if (cells.distanceAt(cell.x(), cell.y()) == DistanceField::UNREACHABLE) return;
+    beginPath(path, kind, target, cells.width(), cells.height());
+
+    // 沿距离场下降，一样短的几条路线里挑别人不挤的那一格，并把经过的时间段预约下来
+    const int owner = bot->handle().index;
+    const QPoint self = bot->centerCell();
+    const quint64 now = m_engine->timerNow();
+    m_reservations.release(owner);
+    // 追目标时停在目标旁边一格：炸弹已经够得着，也不会和目标挤在同一格
+    const quint16 stop = kind == BotPath::TARGET ? 1 : 0;
+    QPoint cur = cell;
+    path.cells.append(cur);
+    path.depends.set(cur.x(), cur.y());
+    while (cells.distanceAt(cur.x(), cur.y()) > stop) {
+        const quint16 want = quint16(cells.distanceAt(cur.x(), cur.y()) - 1);
+        // 第 i 格在走前一格时就开始压到，走完下一格才离开
+        const quint64 from = now + quint64(path.cells.size() - 1) * CELL_MOVE_TICKS;
+        const quint64 to = from + 2 * CELL_MOVE_TICKS;
+        QPoint best;
+        int bestCost = -1;
+        for (const QPoint &d : CELL_STEPS) {
+            const QPoint next = cur + d;
+            if (cells.distanceAt(next.x(), next.y()) != want) continue;
+            const int cost = m_reservations.cost(owner, self, next.x(), next.y(), from, to);
+            if (bestCost < 0 || cost < bestCost) {
+                best = next;
+                bestCost = cost;
+            }
+        }
+        if (bestCost < 0) break;
+        cur = best;
+        path.cells.append(cur);
+        path.depends.set(cur.x(), cur.y());
+        m_reservations.claim(owner, cur.x(), cur.y(), from, to);
+    }
+}
+
+bool GameBotManager::storeChase(Player *bot, BotPath &path, Player *target, const QPoint &cell)
+{
+    // 目标压得最多的那一格是终点；目标脚下可能有炸弹或者火焰，终点本身不查
+    const TileMap &tiles = m_engine->tileMap();
+    const QPoint goal = target->centerCell();
+    auto routable = [this, &goal](int col, int row) {
+        return QPoint(col, row) == goal || isCellRoutable(col, row, m_danger);
+    };
+    if (!m_jumps.findPath(tiles.columns(), tiles.rows(), cell, goal, routable, m_chaseCells)) return false;
+    // 追目标时停在目标旁边一格：炸弹已经够得着，也不会和目标挤在同一格
+    if (m_chaseCells.size() > 1) m_chaseCells.removeLast();
+
+    // 同一条路线上经过的时间段预约下来，和 storePath 一样
+    beginPath(path, BotPath::TARGET, target, tiles.columns(), tiles.rows());
+    const int owner = bot->handle().index;
+    const quint64 now = m_engine->timerNow();
+    m_reservations.release(owner);
+    for (int i = 0; i < m_chaseCells.size(); ++i) {
+        const QPoint &cur = m_chaseCells[i];
+        path.cells.append(cur);
+        path.depends.set(cur.x(), cur.y());
+        if (i == 0) continue;
+        const quint64 from = now + quint64(i - 1) * CELL_MOVE_TICKS;
+        m_reservations.claim(owner, cur.x(), cur.y(), from, from + 2 * CELL_MOVE_TICKS);
+    }
+    return true;
+}
+
+void GameBotManager::beginPath(BotPath &path, BotPath::Kind kind, Player *target, int columns, int rows) const
+{
+    path.kind = kind;
+    path.target = target;
+    path.cells.resize(0);
+    path.next = 1;
+    if (path.depends.width() != columns || path.depends.height() != rows) {
+        path.depends.resize(columns, rows);
     } else {
-        options << QPoint(0, step.y()) << QPoint(step.x(), 0);
-    }
-    for (const QPoint &o : options) {
-        QPoint nc = botCell + o * GameConstants::LOGIC_UNIT; // 与玩家同步的1单位步长
-        if (!isCellWalkable(nc.x(), nc.y())) continue;
-        if (danger.contains(nc)) continue;
-        if (o == QPoint(1,0)) bot->moveRight();
-        else if (o == QPoint(-1,0)) bot->moveLeft();
-        else if (o == QPoint(0,1)) bot->moveDown();
-        else if (o == QPoint(0,-1)) bot->moveUp();
-        return true;
+        path.depends.clear();
     }
-    return false;
 }
 
-bool GameBotManager::moveBotAway(Player *bot, const QSet<QPoint> &danger)
+void GameBotManager::invalidatePaths(int col, int row)
 {
-    QPoint botCell = snapPlayerCell(bot);
-    if (!danger.contains(botCell)) return false;
-    QVector<QPoint> dirs = {QPoint(1,0), QPoint(-1,0), QPoint(0,1), QPoint(0,-1)};
-    for (const QPoint &d : dirs) {
-        QPoint nc = botCell + d * GameConstants::LOGIC_UNIT; // 与玩家同步的1单位步长
-        if (!isCellWalkable(nc.x(), nc.y())) continue;
-        if (danger.contains(nc)) continue;
-        if (d == QPoint(1,0)) bot->moveRight();
-        else if (d == QPoint(-1,0)) bot->moveLeft();
-        else if (d == QPoint(0,1)) bot->moveDown();
-        else if (d == QPoint(0,-1)) bot->moveUp();
-        return true;
+    for (BotAgent &agent : m_agents) {
+        if (agent.path.kind != BotPath::NONE && agent.path.depends.test(col, row)) {
+            dropPath(agent);
+        }
+    }
+}
+
+void GameBotManager::dropPath(BotAgent &agent)
+{
+    // 沿路线排好的移动跟着作废；逃生动作是按危险时间线排的，不受影响
+    agent.path.kind = BotPath::NONE;
+    m_reservations.release(agent.owner.index);
+    if (!agent.escaping) agent.actions.clear();
+}
+
+void GameBotManager::invalidateBlast(const BlastIndex::Blast &blast)
+{
+    BlastIndex::forEachCell(blast, [this](int col, int row) {
+        invalidatePaths(col, row);
+    });
+}
+
+void GameBotManager::invalidateEscapes(const Bomb *bomb)
+{
+    // 逃生路线是放这颗炸弹之前规划的：火焰会烧到剩下的路线时作废
+    // 按这颗炸弹规划的逃生（机器人自己刚放下的）不受影响
+    for (Player *bot : m_bots.values()) {
+        if (!bot) continue;
+        BotAgent &agent = agentOf(bot);
+        if (!agent.escaping) continue;
+        if (agent.plannedBomb == bomb->getBombPosition()) {
+            agent.plannedBomb = QPoint(-1, -1);
+            continue;
+        }
+        if (!escapeCrosses(bot, agent, bomb)) continue;
+        agent.escaping = false;
+        agent.resumeEscape = true;
+        dropPath(agent);
+    }
+}
+
+bool GameBotManager::escapeCrosses(Player *bot, const BotAgent &agent, const Bomb *bomb) const
+{
+    // 按队列回放剩下的移动：身体压着的方格在压着的那段时间里会被这颗炸弹的火焰烧到才算
+    // 火焰要等引信燃尽，只是经过火焰范围（包括踩过还没爆的炸弹）的路线照走；
+    // 终点落在火焰范围里也不管，停下之后还有好几次决策可以按时间线再躲
+    const DangerTimeline &timeline = m_engine->dangerTimeline();
+    const BlastIndex::Blast &blast = bomb->blast();
+    auto crosses = [&](const QPoint &pos, quint64 from, quint64 to) {
+        const int left = TileMap::cellOf(pos.x());
+        const int right = TileMap::cellOf(pos.x() + GameConstants::BLOCK_SIZE - 1);
+        const int top = TileMap::cellOf(pos.y());
+        const int bottom = TileMap::cellOf(pos.y() + GameConstants::BLOCK_SIZE - 1);
+        for (int row = top; row <= bottom; ++row) {
+            for (int col = left; col <= right; ++col) {
+                if (!blast.reaches(col, row)) continue;
+                const DangerTimeline::Window &window = timeline.windowAt(col, row);
+                if (!window.isEmpty() && window.start <= to && window.end > from) return true;
+            }
+        }
+        return false;
+    };
+    QPoint pos = bot->stepTarget();
+    quint64 from = m_engine->timerNow() + quint64(bot->stepTicksLeft());
+    for (const BotAction &action : agent.actions) {
+        if (action.type != BotAction::MOVE) continue;
+        const quint64 leave = qMax(action.notBefore, from) + GameConstants::MOVE_STEP_TICKS;
+        if (crosses(pos, from, leave)) return true;
+        pos += action.step;
+        from = qMax(action.notBefore, from);
     }
     return false;
 }
 
-bool GameBotManager::hasDestructibleBrickInRange(Player *bot, const QSet<QPoint> &danger) const
+void GameBotManager::invalidateTarget(Player *target)
+{
+    for (BotAgent &agent : m_agents) {
+        if (agent.path.kind == BotPath::TARGET && agent.path.target == target) {
+            dropPath(agent);
+        }
+    }
+}
+
+void GameBotManager::invalidateOpening(int col, int row)
+{
+    // 新打通的方格可能是捷径，紧挨着它走的路线重新规划；离得远的继续走原来的路线
+    // 拆砖路线的终点紧挨砖块，砖块炸掉时也在这里作废
+    invalidatePaths(col, row);
+    invalidatePaths(col + 1, row);
+    invalidatePaths(col - 1, row);
+    invalidatePaths(col, row + 1);
+    invalidatePaths(col, row - 1);
+}
+
+bool GameBotManager::queueBombDrop(Player *bot)
+{
+    // 按这颗炸弹规划好逃生路线，放炸弹和逃离一起排进动作队列
+    const QPoint pos = snapPlayerCell(bot);
+    const QPoint bombPos((pos.x() / GameConstants::BLOCK_SIZE) * GameConstants::BLOCK_SIZE,
+                         (pos.y() / GameConstants::BLOCK_SIZE) * GameConstants::BLOCK_SIZE);
+    EscapePlanner::Plan plan;
+    if (!planEscape(bot, &bombPos, plan)) return false;
+
+    BotAgent &agent = agentOf(bot);
+    agent.actions.clear();
+    BotAction drop;
+    drop.type = BotAction::BOMB;
+    drop.notBefore = m_engine->timerNow();
+    agent.actions.enqueue(drop);
+    queueEscape(bot, agent, plan);
+    agent.plannedBomb = bombPos;
+    return true;
+}
+
+void GameBotManager::queueMoves(BotAgent &agent, const QPoint &step, int units)
+{
+    BotAction move;
+    move.type = BotAction::MOVE;
+    move.step = step;
+    move.notBefore = 0;
+    for (int i = 0; i < units; ++i) {
+        agent.actions.enqueue(move);
+    }
+}
+
+void GameBotManager::queueEscape(Player *bot, BotAgent &agent, const EscapePlanner::Plan &plan)
+{
+    // 逃生路线是对照火焰时间窗按移动节奏规划的，走得比规划快可能撞上还没熄灭的火焰，
+    // 所以每一步都带上规划时的时间，原地等待的那几步不用排
+    // 经过的格子和落脚点同时预约下来，别的机器人逃生时尽量不挤到同一个地方
+    const int owner = bot->handle().index;
+    m_reservations.release(owner);
+    QPoint pos = bot->stepTarget();
+    BotAction move;
+    move.type = BotAction::MOVE;
+    for (int k = 0; k < plan.steps; ++k) {
+        const quint64 at = plan.departure + quint64(k) * GameConstants::MOVE_STEP_TICKS;
+        const QPoint cell = centerCell(pos);
+        m_reservations.claim(owner, cell.x(), cell.y(), at, at + GameConstants::MOVE_STEP_TICKS);
+        pos += plan.moves[k];
+        if (plan.moves[k].isNull()) continue;
+        move.step = plan.moves[k];
+        move.notBefore = at;
+        agent.actions.enqueue(move);
+    }
+    const QPoint rest = centerCell(pos);
+    m_reservations.claim(owner, rest.x(), rest.y(), plan.arrival, plan.arrival + ESCAPE_HOLD_TICKS);
+    agent.escaping = true;
+    agent.resumeEscape = false;
+    agent.plannedBomb = QPoint(-1, -1);
+}
+
+int GameBotManager::ticksUntilFlame(const Player *bot) const
+{
+    // 身体压着的方格里最早起火的那个；已经在烧为 0，都不会起火为 -1
+    const DangerTimeline &timeline = m_engine->dangerTimeline();
+    const quint64 now = m_engine->timerNow();
+    const QRect cells = bot->coveredCells();
+    int earliest = -1;
+    for (int row = cells.top(); row <= cells.bottom(); ++row) {
+        for (int col = cells.left(); col <= cells.right(); ++col) {
+            const int ticks = timeline.ticksUntilFlame(col, row, now);
+            if (ticks >= 0 && (earliest < 0 || ticks < earliest)) earliest = ticks;
+        }
+    }
+    return earliest;
+}
+
+bool GameBotManager::planEscape(Player *bot, const QPoint *bombPos, EscapePlanner::Plan &plan) const
+{
+    const DangerTimeline &timeline = m_engine->dangerTimeline();
+    const WalkabilityMap &walkability = m_engine->walkability();
+    const quint64 now = m_engine->timerNow();
+
+    // 正在走的这一步走完才能开始逃：从这一步的终点、走完的时间开始规划
+    const QPoint start = bot->stepTarget();
+    const quint64 departure = now + quint64(bot->stepTicksLeft());
+
+    const QRect standing = bot->coveredCells();
+    auto passable = [&walkability, &standing](int x, int y) {
+        return passableFrom(walkability, standing, x, y);
+    };
+
+    // 同样快的路线里选离危险区最远的终点，给之后新放的炸弹留余地
+    // 已经有别人站着或者预约了的落脚点扣分，几个机器人躲同一颗炸弹时各自散开
+    // 落在死胡同或小口袋里也扣分：出口被下一颗炸弹一堵就是死角
+    // 死胡同是 O(1) 的局部判断，口袋统计漏报（DFS 根落在口袋里）时也能兜住
+    const DistanceField &field = hazardField();
+    const MapTopology &topology = m_engine->topology();
+    const int owner = bot->handle().index;
+    const QPoint self = bot->centerCell();
+    auto clearance = [this, &field, &topology, owner, self, now](int x, int y) {
+        const QPoint cell = centerCell(QPoint(x, y));
+        const int crowd = m_reservations.cost(owner, self, cell.x(), cell.y(), now, now + ESCAPE_HOLD_TICKS);
+        const int pocket = topology.pocketSize(cell.x(), cell.y());
+        const int cornered = ((pocket > 0 && pocket <= SMALL_POCKET_CELLS)
+                              || topology.kindAt(cell.x(), cell.y()) == MapTopology::DEAD_END) ? 1 : 0;
+        return int(field.distanceAt(x, y)) - (crowd + cornered) * GameConstants::BLOCK_SIZE;
+    };
+
+    if (!bombPos) {
+        return m_escape.plan(start, departure, passable, [&timeline](int col, int row) {
+            return timeline.windowAt(col, row);
+        }, clearance, plan);
+    }
+
+    // 假设在 bombPos 放一颗炸弹：引信燃尽时爆炸，被更早的火焰碰到时跟着提前
+    const int col = TileMap::cellOf(bombPos->x());
+    const int row = TileMap::cellOf(bombPos->y());
+    const BlastIndex::Blast blast = m_engine->blastIndex().blastAt(col, row, bot->bombRange());
+    DangerTimeline::Window extra;
+    extra.start = now + GameConstants::BOMB_FUSE_TICKS;
+    const DangerTimeline::Window &under = timeline.windowAt(col, row);
+    if (!under.isEmpty() && under.start > now) {
+        extra.start = qMin(extra.start, under.start);
+    }
+    extra.end = extra.start + GameConstants::EXPLOSION_TICKS;
+    return m_escape.plan(start, departure, passable, [&timeline, &blast, &extra](int c, int r) {
+        DangerTimeline::Window window = timeline.windowAt(c, r);
+        if (blast.reaches(c, r)) {
+            window.start = qMin(window.start, extra.start);
+            window.end = qMax(window.end, extra.end);
+        }
+        return window;
+    }, clearance, plan);
+}
+
+bool GameBotManager::hasDestructibleBrickInRange(Player *bot) const
 {
     if (!bot) return false;
     
     QPoint botCell = snapPlayerCell(bot);
     
     // 检查炸弹爆炸范围内是否有可破坏的砖块
-    int bombRange = 1; // 默认炸弹范围为1个单位
+    const int bombRange = bot->bombRange();  // 火焰每个方向能走几格
     
     for (int i = 0; i <= bombRange; ++i) { // 从当前位置开始（包括原地）
         // 检查上下左右方向
-        QPoint up(botCell.x(), botCell.y() - i * Block::SIZE_UNITS);
-        QPoint down(botCell.x(), botCell.y() + i * Block::SIZE_UNITS);
-        QPoint left(botCell.x() - i * Block::SIZE_UNITS, botCell.y());
-        QPoint right(botCell.x() + i * Block::SIZE_UNITS, botCell.y());
+        QPoint up(botCell.x(), botCell.y() - i * GameConstants::BLOCK_SIZE);
+        QPoint down(botCell.x(), botCell.y() + i * GameConstants::BLOCK_SIZE);
+        QPoint left(botCell.x() - i * GameConstants::BLOCK_SIZE, botCell.y());
+        QPoint right(botCell.x() + i * GameConstants::BLOCK_SIZE, botCell.y());
         
         QVector<QPoint> checkPositions = {botCell, up, down, left, right}; // 包括当前位置
         
@@ -865,13 +975,8 @@ bool GameBotManager::hasDestructibleBrickInRange(Player *bot, const QSet<QPoint>
             if (pos == botCell) continue; // 跳过机器人自身位置
             
             // 检查该位置是否有可破坏的砖块
-            const QList<Block*> &blocks = m_engine->blocks();
-            for (Block *block : blocks) {
-                if (block->isDestructible() && 
-                    static_cast<int>(block->x() / GameConstants::UNIT_SIZE) == pos.x() &&
-                    static_cast<int>(block->y() / GameConstants::UNIT_SIZE) == pos.y()) {
-                    return true; // 找到可破坏的砖块
-                }
+            if (m_engine->tileMap().tileAtUnits(pos.x(), pos.y()) == TileMap::BRICK) {
+                return true; // 找到可破坏的砖块
             }
         }
     }
@@ -883,7 +988,19 @@ void GameBotManager::botPlaceBomb(Player *bot)
 {
     QPoint cell = snapPlayerCell(bot);
     // 对齐到格子中心（4单位一格），否则放置会失败
-    int gx = (cell.x() / Block::SIZE_UNITS) * Block::SIZE_UNITS;
-    int gy = (cell.y() / Block::SIZE_UNITS) * Block::SIZE_UNITS;
-    m_engine->createBombAtCell(gx, gy);
+    int gx = (cell.x() / GameConstants::BLOCK_SIZE) * GameConstants::BLOCK_SIZE;
+    int gy = (cell.y() / GameConstants::BLOCK_SIZE) * GameConstants::BLOCK_SIZE;
+    m_engine->createBombAtCell(gx, gy, bot->bombRange());
+    m_bombSpotsDirty = true;
+}
+
+const BombSpotMap& GameBotManager::bombSpots(int range) const
+{
+    // 机器人的射程一样时整张表所有机器人共用，射程不同才按需重算
+    if (m_bombSpotsDirty || m_bombSpots.range() != range) {
+        m_bombSpots.rebuild(m_engine->tileMap(), m_engine->walkability(), m_engine->blastIndex(),
+                            m_engine->dangerTimeline(), m_engine->timerNow(), range);
+        m_bombSpotsDirty = false;
+    }
+    return m_bombSpots;
 }
@@ -2,15 +2,23 @@
 #define GAMEBOTMANAGER_H
 
 #include <QObject>
-#include <QSet>
 #include <QPoint>
 #include <QVector>
 #include <QQueue>
 #include <QHash>
 #include "gameconstants.h"
+#include "slotmap.h"
+#include "distancefield.h"
+#include "gridbitset.h"
+#include "escapeplanner.h"
+#include "cellrouter.h"
+#include "jumppointsearch.h"
+#include "bombspotmap.h"
+#include "reservationtable.h"
 
 class GameEngine;
 class Player;
+class Bomb;
 
 class GameBotManager : public QObject
 {
@@ -21,36 +29,118 @@ public:
 
     void spawnBots();
     void clearBots();
-    void updateBots();
+    void updateBots();   // 每 BOT_THINK_TICKS 个 tick 决策一次
+    void runActions();   // 每个 tick 执行排好的动作
 
 public:
-    QList<Player*> getBots() const; // 获取所有AI机器人列表
-    void removeBot(Player *bot);    // 移除指定的AI机器人
+    const QVector<Player*>& getBots() const { return m_bots.values(); } // 获取所有AI机器人列表
+    void removeBot(Player *bot);    // 移除指定的AI机器人，O(1)
+
+signals:
+    void botAdded(Player *bot);
+    void botRemoved(Player *bot);   // 发出后对象会被释放
 
 private:
     GameEngine *m_engine;
-    QVector<Player*> m_bots;
+    SlotMap<Player*> m_bots;
+    mutable EscapePlanner m_escape;    // 时空逃生规划，所有机器人共用
+
+    // 每次决策共享的距离场，第一次用到时才算；局面平静时机器人都沿缓存路线走，一个也不用算
+    // 本次决策的危险位图（逻辑单位）：第 (x, y) 位表示身体左上角放在这里会压到危险方格
+    GridBitset m_danger;   // 当前 + 未来
+    GridBitset m_burning;  // 当前
+    mutable GridBitset m_scratch;  // 位图运算的临时结果
+    mutable DistanceField m_safetyField;  // 到最近安全位置
+    mutable CellRouter m_brickRoute;      // 到最近能炸到砖块的方格（方格图）
+    mutable DistanceField m_hazardField;  // 到最近危险位置（危险距离变换）
+    mutable bool m_safetyDirty = true;
+    mutable bool m_brickRouteDirty = true;
+    mutable bool m_hazardDirty = true;
+    QVector<CellRouter> m_targetRoutes;      // 到各个目标（方格图），按需计算
+    JumpPointSearch m_jumps;                 // 在方格原点上追目标时的点到点寻路（方格图）
+    QVector<QPoint> m_chaseCells;            // 跳点搜索找到的路线，复用
+    QVector<Player*> m_targetRouteOwners;    // m_targetRoutes 对应的目标
+    mutable QVector<QPoint> m_fieldSources;  // 复用的源点列表
+    mutable BombSpotMap m_bombSpots;         // 哪些方格放炸弹后还能逃生
+    mutable bool m_bombSpotsDirty = true;    // 每次决策和放下炸弹后重算
+
+    // 机器人正在跟随的方格路线；地图事件（砖块炸掉、炸弹放下/移除、目标换格）只作废受影响的路线
+    struct BotPath {
+        enum Kind { NONE, TARGET, BRICK };
+        Kind kind = NONE;
+        Player *target = nullptr;  // TARGET 路线追的目标
+        QVector<QPoint> cells;     // 方格坐标，cells[0] 是规划时所在的方格
+        int next = 0;              // 下一个要到达的方格
+        GridBitset depends;        // 路线经过的方格
+    };
+    // 排好的动作，引擎每个 tick 按移动节奏取出执行
+    struct BotAction {
+        enum Type { MOVE, BOMB };
+        Type type = MOVE;
+        QPoint step;              // MOVE 的方向
+        quint64 notBefore = 0;    // 最早执行的定时器时间，逃生路线按规划的节奏走
+    };
+    // 每个机器人的路线和动作队列，下标是机器人句柄的槽位
+    // 队列空了、路线作废或者遇到危险时才重新决策
+    struct BotAgent {
+        EntityHandle owner;
+        BotPath path;
+        QQueue<BotAction> actions;
+        bool escaping = false;    // 队列来自逃生规划，路线作废时保留
+        QPoint plannedBomb = QPoint(-1, -1);  // 逃生规划假设要放的炸弹（逻辑单位），放下之前有效
+        bool resumeEscape = false;  // 逃生路线被打断，下次决策立即重新规划逃生
+    };
+    QVector<BotAgent> m_agents;
+    ReservationTable m_reservations;  // 身体占用和路线预约，所有机器人共用
+
+    void resetSharedFields();
+    const DistanceField& safetyField() const;
+    const DistanceField& hazardField() const;
+    const CellRouter& brickRoute() const;
+    const CellRouter& targetRoute(Player *target);
+    const BombSpotMap& bombSpots(int range) const;
+
+    // 路线缓存
+    BotAgent& agentOf(Player *bot);
+    // target 为空时走拆砖路线；缓存失效时才重新寻路，并在方格原点上重新记下路线
+    // units 是沿 step 方向连续走几步（走到下一个方格原点）
+    bool pathStep(Player *bot, Player *target, QPoint &step, int &units);
+    bool followPath(BotPath &path, const QPoint &pos, QPoint &step, int &units) const;
+    void beginPath(BotPath &path, BotPath::Kind kind, Player *target, int columns, int rows) const;
+    void storePath(Player *bot, BotPath &path, BotPath::Kind kind, Player *target,
+                   const CellRouter &route, const QPoint &cell);
+    bool storeChase(Player *bot, BotPath &path, Player *target, const QPoint &cell);  // 跳点搜索记下追目标的路线
+    void invalidatePaths(int col, int row);  // 经过该方格的路线作废
+    void dropPath(BotAgent &agent);
+    void invalidateBlast(const BlastIndex::Blast &blast);
+    void invalidateOpening(int col, int row);  // 方格变空：经过它和它旁边的路线都重新规划
+    void invalidateTarget(Player *target);     // 目标换了格子或被移除
+    void invalidateEscapes(const Bomb *bomb);  // 新炸弹的火焰会烧到剩下的逃生路线时作废
+    bool escapeCrosses(Player *bot, const BotAgent &agent, const Bomb *bomb) const;
 
     QPoint snapPlayerCell(Player *p) const;
-    QSet<QPoint> computeDangerCells() const;
-    QSet<QPoint> computeFutureDangerCells(int timeSteps = 3) const; // 预测未来危险区域
+    void computeDanger(int horizonTicks, GridBitset &danger) const; // horizonTicks 内会起火的方格，按身体大小膨胀
+    bool isInDanger(const QPoint &pos, const GridBitset &danger) const; // 按身体覆盖的方格判断
     bool isCellWalkable(int x, int y) const;
-    bool isCellInBombRange(const QPoint &cell) const; // 检查单元格是否在炸弹爆炸范围内
-    bool bfsNextStep(const QPoint &start, const QPoint &goal, const QSet<QPoint> &danger, QPoint &nextStep) const;
-    bool canReachPlayer(const QPoint &botCell, const QPoint &playerCell, const QSet<QPoint> &danger) const;
-    bool findNearestBrickStep(const QPoint &botCell, const QSet<QPoint> &danger, QPoint &nextStep) const;
-    bool findSafeStep(const QPoint &botCell, const QSet<QPoint> &danger, QPoint &nextStep) const;
-    bool findEscapeRoute(const QPoint &botCell, const QSet<QPoint> &danger, QPoint &nextStep) const; // 寻找最佳逃生路径
-    bool hasDestructibleBrickInRange(Player *bot, const QSet<QPoint> &danger) const; // 检查机器人附近是否有可破坏的砖块
-    QVector<QPoint> neighbors(const QPoint &cell) const;
+    bool canReachPlayer(const QPoint &botCell, const QPoint &playerCell) const; // 逻辑单位位置，忽略危险区
+    int ticksUntilFlame(const Player *bot) const; // 身体压着的方格最早多久后起火，不会起火为 -1
+    // 按危险时间线规划最快的逃生路线；bombPos 不为空时假设先在那里放一颗炸弹
+    bool planEscape(Player *bot, const QPoint *bombPos, EscapePlanner::Plan &plan) const;
+    bool hasDestructibleBrickInRange(Player *bot) const; // 检查机器人附近是否有可破坏的砖块
 
     // 改进的AI行为函数
-    bool moveBotToward(Player *bot, const QPoint &target, const QSet<QPoint> &danger);
-    bool moveBotAway(Player *bot, const QSet<QPoint> &danger);
+    bool moveBotToward(Player *bot, Player *target);
+    bool routeStep(Player *bot, const CellRouter &route, QPoint &step) const;
+    bool isCellRoutable(int col, int row, const GridBitset &danger) const;
+    void moveBotStep(Player *bot, const QPoint &step);
     void botPlaceBomb(Player *bot);
-    bool shouldPlaceBomb(Player *bot, const QSet<QPoint> &danger) const; // 决定是否放置炸弹
-    bool canTrapTarget(Player *bot, const QPoint &targetPos) const; // 检查是否可以困住目标
-    QSet<QPoint> getBombDangerArea(const QPoint &bombPos) const; // 获取炸弹爆炸危险区域
+    // 动作队列
+    bool queueBombDrop(Player *bot);  // 规划好逃生路线后把放炸弹和逃离一起排进队列
+    void queueMoves(BotAgent &agent, const QPoint &step, int units);
+    void queueEscape(Player *bot, BotAgent &agent, const EscapePlanner::Plan &plan);
+    bool shouldPlaceBomb(Player *bot) const; // 有目标且放下后能逃生时才放炸弹
+    bool isSafeBombSpot(Player *bot) const;  // 只查安全放弹表，不看有没有目标
+    bool canTrapTarget(Player *bot, const QPoint &targetPos) const; // 在脚下放炸弹能否把目标关在小口袋里
     bool isPlayerInBombRange(Player *bot, Player *target) const; // 检查目标是否在爆炸范围内
     void prioritizeTargets(QVector<Player*> &targets, Player *currentBot) const; // 优先级排序目标
 };
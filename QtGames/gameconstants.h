@@ -6,9 +6,22 @@ namespace GameConstants {
     inline constexpr int UNIT_SIZE = 8;
     inline constexpr int LOGIC_UNIT = 1;
     inline constexpr int BLOCK_SIZE = 4;
+    inline constexpr int BLOCK_PIXELS = BLOCK_SIZE * UNIT_SIZE;        // 32
     inline constexpr int MAP_GRID_COUNT = 25;
     inline constexpr int MAP_SIZE_UNITS = 25 * 4;          // 100
     inline constexpr int MAP_SIZE_PIXELS = MAP_SIZE_UNITS * UNIT_SIZE; // 800
+
+    // Fixed simulation step; every duration below is a whole number of ticks
+    inline constexpr int TICK_MS = 25;                                 // 40 ticks per second
+    inline constexpr int MOVE_STEP_TICKS = 75 / TICK_MS;               // one logic unit per 75ms
+    inline constexpr int BOT_THINK_TICKS = 150 / TICK_MS;              // bot decision every 150ms
+    inline constexpr int BOMB_FUSE_TICKS = 2000 / TICK_MS;             // 2s fuse
+    inline constexpr int EXPLOSION_TICKS = 400 / TICK_MS;              // flames last 400ms
+    inline constexpr int BOMB_RANGE = 1;                               // flame reach in cells
+
+    // Fixed-point positions: a logic unit is split into one sub-step per movement tick,
+    // so an interpolated position is always an exact integer
+    inline constexpr int SUBSTEPS_PER_UNIT = MOVE_STEP_TICKS;
 }
 
 #endif // GAMECONSTANTS_H
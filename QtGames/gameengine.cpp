@@ -1,15 +1,12 @@
 #include "gameengine.h"
 #include "gameconstants.h"
-#include <QGraphicsScene>
-#include <QKeyEvent>
 #include <QRandomGenerator>
 #include <QDebug>
-#include <cmath>
+#include <algorithm>
 #include "gamebotmanager.h"
 
-GameEngine::GameEngine(QGraphicsScene *scene, QObject *parent)
+GameEngine::GameEngine(QObject *parent)
     : QObject(parent)
-    , m_scene(scene)
     , m_player(nullptr)
     , m_mapWidth(GameConstants::MAP_SIZE_UNITS)  // 100个单位（25个方格 * 4个单位）
     , m_mapHeight(GameConstants::MAP_SIZE_UNITS)  // 100个单位
@@ -17,20 +14,20 @@ GameEngine::GameEngine(QGraphicsScene *scene, QObject *parent)
     , m_dirY(0)
     , m_lastMoveX(0)
     , m_lastMoveY(0)
-    , m_moveTimer(new QTimer(this))
-    , m_botTimer(new QTimer(this))
+    , m_tick(0)
+    , m_paused(false)
+    , m_gameOver(false)
+    , m_flames(GameConstants::MAP_GRID_COUNT, GameConstants::MAP_GRID_COUNT)
+    , m_chainFlames(GameConstants::MAP_GRID_COUNT, GameConstants::MAP_GRID_COUNT)
+    , m_flamesDirty(false)
+    , m_pendingBombs(GameConstants::MAP_GRID_COUNT * GameConstants::MAP_GRID_COUNT, nullptr)
+    , m_timelineDirty(true)
+    , m_rng(QRandomGenerator::global()->generate())
     , m_botManager(new GameBotManager(this))
 {
-    m_moveTimer->setInterval(10); // 10ms 检查一次，衔接动画完成后继续移动
-    connect(m_moveTimer, &QTimer::timeout, this, &GameEngine::tryMoveStep);
-    m_moveTimer->start();
-    
-    // Bot AI 定时器
-    m_botTimer->setInterval(150); // 约每150ms做一次决策
-    connect(m_botTimer, &QTimer::timeout, this, [this]() {
-        if (m_botManager) m_botManager->updateBots();
-    });
-    m_botTimer->start();
+    // 机器人的加入/移除同样通知渲染层
+    connect(m_botManager, &GameBotManager::botAdded, this, &GameEngine::playerAdded);
+    connect(m_botManager, &GameBotManager::botRemoved, this, &GameEngine::playerRemoved);
 }
 
 GameEngine::~GameEngine()
@@ -39,12 +36,9 @@ GameEngine::~GameEngine()
     if (m_botManager) {
         m_botManager->clearBots();
     }
-    for (Bomb *bomb : m_bombs) {
+    for (Bomb *bomb : m_bombs.values()) {
         delete bomb;
     }
-    for (Block *block : m_blocks) {
-        delete block;
-    }
     if (m_player) {
         delete m_player;
     }
@@ -52,22 +46,26 @@ GameEngine::~GameEngine()
 
 void GameEngine::initializeGame()
 {
-    if (!m_scene) return;
-    
-    // 清空场景
-    m_scene->clear();
-    m_bombs.clear();
-    m_blocks.clear();
-    if (m_botManager) {
-        m_botManager->clearBots();
-    }
+    // 清空上一局的世界状态
+    clearWorld();
+    m_tick = 0;
+    m_paused = false;
+    m_gameOver = false;
     
     // 创建地图
     createMap();
+    m_walkability.rebuild(m_tiles);
+    m_blast.rebuild(m_tiles);
+    m_regions.rebuild(m_tiles);
+    m_topology.rebuild(m_tiles);
+    validateMap();
+    m_timeline.reset(m_tiles.columns(), m_tiles.rows());
+    m_timelineDirty = true;
+    emit mapLoaded();
     
     // 创建玩家（放在左上角安全位置，使用逻辑单位，避开内侧墙）
-    m_player = new Player(Block::SIZE_UNITS, Block::SIZE_UNITS);
-    m_scene->addItem(m_player);
+    m_player = new Player(GameConstants::BLOCK_SIZE, GameConstants::BLOCK_SIZE);
+    emit playerAdded(m_player);
     
     // 创建AI机器人，出生在其余三个角
     if (m_botManager) {
@@ -75,11 +73,39 @@ void GameEngine::initializeGame()
     }
 }
 
+void GameEngine::clearWorld()
+{
+    if (m_botManager) {
+        m_botManager->clearBots();
+    }
+    for (Bomb *bomb : m_bombs.values()) {
+        emit bombRemoved(bomb);
+        delete bomb;
+    }
+    m_bombs.clear();
+    m_timers.clear();
+    m_flames.clear();
+    m_flamesDirty = false;
+    m_pendingBombs.fill(nullptr);
+    m_timelineDirty = true;
+    if (m_player) {
+        emit playerRemoved(m_player);
+        delete m_player;
+        m_player = nullptr;
+    }
+    m_tiles.reset();
+}
+
+const QVector<Player*>& GameEngine::bots() const
+{
+    return m_botManager->getBots();
+}
+
 void GameEngine::createMap()
 {
     auto inCornerSafe = [&](int x, int y) {
         // 预留四角 2x2 内部空区（不含边界墙），边界占1格，因此取3格跨度
-        int span = Block::SIZE_UNITS * 3; // 1格边界 + 2格空区
+        int span = GameConstants::BLOCK_SIZE * 3; // 1格边界 + 2格空区
         bool left   = x < span;
         bool right  = x >= m_mapWidth  - span;
         bool top    = y < span;
@@ -88,140 +114,267 @@ void GameEngine::createMap()
     };
 
     // 创建边界墙（使用逻辑单位）
-    for (int x = 0; x < m_mapWidth; x += Block::SIZE_UNITS) {
+    for (int x = 0; x < m_mapWidth; x += GameConstants::BLOCK_SIZE) {
         // 上边界
-        Block *wall1 = new Block(x, 0, Block::WALL);
-        m_scene->addItem(wall1);
-        m_blocks.append(wall1);
+        addBlock(x, 0, TileMap::WALL);
         
         // 下边界
-        Block *wall2 = new Block(x, m_mapHeight - Block::SIZE_UNITS, Block::WALL);
-        m_scene->addItem(wall2);
-        m_blocks.append(wall2);
+        addBlock(x, m_mapHeight - GameConstants::BLOCK_SIZE, TileMap::WALL);
     }
     
-    for (int y = Block::SIZE_UNITS; y < m_mapHeight - Block::SIZE_UNITS; y += Block::SIZE_UNITS) {
+    for (int y = GameConstants::BLOCK_SIZE; y < m_mapHeight - GameConstants::BLOCK_SIZE; y += GameConstants::BLOCK_SIZE) {
         // 左边界
-        Block *wall1 = new Block(0, y, Block::WALL);
-        m_scene->addItem(wall1);
-        m_blocks.append(wall1);
+        addBlock(0, y, TileMap::WALL);
         
         // 右边界
-        Block *wall2 = new Block(m_mapWidth - Block::SIZE_UNITS, y, Block::WALL);
-        m_scene->addItem(wall2);
-        m_blocks.append(wall2);
+        addBlock(m_mapWidth - GameConstants::BLOCK_SIZE, y, TileMap::WALL);
     }
     
     // 创建内部网格墙（每隔一个位置放一个不可破坏的墙）
-    for (int x = Block::SIZE_UNITS * 2; x < m_mapWidth - Block::SIZE_UNITS; x += Block::SIZE_UNITS * 2) {
-        for (int y = Block::SIZE_UNITS * 2; y < m_mapHeight - Block::SIZE_UNITS; y += Block::SIZE_UNITS * 2) {
+    for (int x = GameConstants::BLOCK_SIZE * 2; x < m_mapWidth - GameConstants::BLOCK_SIZE; x += GameConstants::BLOCK_SIZE * 2) {
+        for (int y = GameConstants::BLOCK_SIZE * 2; y < m_mapHeight - GameConstants::BLOCK_SIZE; y += GameConstants::BLOCK_SIZE * 2) {
             // 避开四个角的 3x3 空区
             if (inCornerSafe(x, y)) {
                 continue;
             }
-            Block *wall = new Block(x, y, Block::WALL);
-            m_scene->addItem(wall);
-            m_blocks.append(wall);
+            addBlock(x, y, TileMap::WALL);
         }
     }
     
     // 随机放置可破坏的砖块（避开玩家起始位置）
-    QRandomGenerator *rng = QRandomGenerator::global();
-    for (int x = Block::SIZE_UNITS; x < m_mapWidth - Block::SIZE_UNITS; x += Block::SIZE_UNITS) {
-        for (int y = Block::SIZE_UNITS; y < m_mapHeight - Block::SIZE_UNITS; y += Block::SIZE_UNITS) {
+    QRandomGenerator *rng = &m_rng;
+    for (int x = GameConstants::BLOCK_SIZE; x < m_mapWidth - GameConstants::BLOCK_SIZE; x += GameConstants::BLOCK_SIZE) {
+        for (int y = GameConstants::BLOCK_SIZE; y < m_mapHeight - GameConstants::BLOCK_SIZE; y += GameConstants::BLOCK_SIZE) {
             // 跳过网格墙的位置和玩家起始位置
-            if ((x % (Block::SIZE_UNITS * 2) == 0 && y % (Block::SIZE_UNITS * 2) == 0) ||
+            if ((x % (GameConstants::BLOCK_SIZE * 2) == 0 && y % (GameConstants::BLOCK_SIZE * 2) == 0) ||
                 inCornerSafe(x, y)) {
                 continue;
             }
             
             // 随机放置砖块（70%概率）
             if (rng->bounded(100) < 70) {
-                Block *brick = new Block(x, y, Block::BRICK);
-                m_scene->addItem(brick);
-                m_blocks.append(brick);
+                addBlock(x, y, TileMap::BRICK);
             }
         }
     }
 }
 
-void GameEngine::handleKeyPress(QKeyEvent *event)
+void GameEngine::validateMap() const
 {
-    if (!m_player) return;
+    // 砖块全部炸掉之后，四个出生点必须在同一个区域里，否则有角落永远走不出去
+    CellRegions open;
+    open.rebuild(m_tiles, true);
+    const int last = m_tiles.columns() - 2;
+    const QPoint spawns[] = { QPoint(1, 1), QPoint(last, 1), QPoint(1, last), QPoint(last, last) };
+    for (const QPoint &spawn : spawns) {
+        if (!open.connected(spawns[0], spawn)) {
+            qWarning() << "地图不连通：出生点" << spawn << "与左上角隔开";
+        }
+    }
+}
+
+void GameEngine::addBlock(int x, int y, TileMap::Tile type)
+{
+    // x, y是逻辑单位，地图按方格存储
+    m_tiles.setTile(TileMap::cellOf(x), TileMap::cellOf(y), type);
+}
+
+void GameEngine::tick()
+{
+    if (m_paused) return;
+    ++m_tick;
+    
+    // 1) 推进所有进行中的移动（一步 MOVE_STEP_TICKS 个 tick）
+    if (m_player) {
+        m_player->advance();
+    }
+    for (Player *bot : bots()) {
+        bot->advance();
+    }
+    
+    // 2) 玩家输入：上一步走完后按住方向键继续移动
+    tryMoveStep();
     
-    switch (event->key()) {
-    case Qt::Key_Up:
-    case Qt::Key_W:
-        m_dirX = 0; m_dirY = -1;
-        interruptForTurn();
-        break;
-    case Qt::Key_Down:
-    case Qt::Key_S:
-        m_dirX = 0; m_dirY = 1;
-        interruptForTurn();
-        break;
-    case Qt::Key_Left:
-    case Qt::Key_A:
-        m_dirX = -1; m_dirY = 0;
-        interruptForTurn();
-        break;
-    case Qt::Key_Right:
-    case Qt::Key_D:
-        m_dirX = 1; m_dirY = 0;
-        interruptForTurn();
-        break;
-    case Qt::Key_Space:
-        placeBomb();
-        break;
-    }
-}
-
-void GameEngine::handleKeyRelease(QKeyEvent *event)
-{
-    switch (event->key()) {
-    case Qt::Key_Up:
-    case Qt::Key_W:
-        if (m_dirY == -1) m_dirY = 0;
-        break;
-    case Qt::Key_Down:
-    case Qt::Key_S:
-        if (m_dirY == 1) m_dirY = 0;
-        break;
-    case Qt::Key_Left:
-    case Qt::Key_A:
-        if (m_dirX == -1) m_dirX = 0;
-        break;
-    case Qt::Key_Right:
-    case Qt::Key_D:
-        if (m_dirX == 1) m_dirX = 0;
-        break;
-    default:
-        break;
+    // 3) 机器人每 BOT_THINK_TICKS 个 tick 决策一次，排好的动作按移动节奏每个 tick 执行
+    if (m_botManager) {
+        if (m_tick % GameConstants::BOT_THINK_TICKS == 0) {
+            m_botManager->updateBots();
+        }
+        m_botManager->runActions();
+    }
+    
+    // 4) 炸弹引信与爆炸，伤害结算放在本 tick 最后
+    advanceBombs();
+}
+
+void GameEngine::advance(int ticks)
+{
+    for (int i = 0; i < ticks; ++i) {
+        tick();
+    }
+}
+
+void GameEngine::advanceBombs()
+{
+    // 只处理本 tick 到期的定时器，定时器里存的是炸弹句柄，炸弹已被移除时跳过
+    m_expired.clear();
+    m_timers.advance(m_expired);
+    m_detonations.clear();
+    for (const TimerWheel::Expired &e : m_expired) {
+        Bomb *bomb = m_bombs.value(EntityHandle::unpack(e.data));
+        if (!bomb) continue;
+        if (e.kind == FUSE_TIMER) {
+            m_detonations.append(bomb);
+        } else {
+            bomb->finishExplosion();
+        }
+    }
+    
+    // 有火焰熄灭时从剩下的爆炸重新光栅化，新的爆炸在连锁结算时直接叠加上去
+    if (m_flamesDirty) {
+        rebuildFlames();
+    }
+    if (!m_detonations.isEmpty()) {
+        resolveDetonations();
+    }
+    if (m_flames.any()) {
+        resolveFlameDamage();
     }
 }
 
+void GameEngine::resolveDetonations()
+{
+    // 同一 tick 引信燃尽的炸弹按方格行优先排序，保证连锁顺序与定时器内部顺序无关
+    std::sort(m_detonations.begin(), m_detonations.end(), [](const Bomb *a, const Bomb *b) {
+        const QPoint pa = a->getBombPosition();
+        const QPoint pb = b->getBombPosition();
+        return pa.y() != pb.y() ? pa.y() < pb.y() : pa.x() < pb.x();
+    });
+    
+    // 广度优先引爆：被火焰碰到的炸弹排到队尾，本 tick 内整条连锁全部引爆
+    // 连锁里的火焰都按引爆前的地形计算，砖块在整条连锁结束后统一炸掉
+    // 引信同时燃尽的炸弹先全部移出待爆表，免得被排在前面的火焰碰到后再入队一次
+    for (Bomb *bomb : m_detonations) {
+        clearPending(bomb);
+    }
+    m_chainFlames.clear();
+    auto ignite = [this](int col, int row) {
+        if (!m_flames.contains(col, row)) return;
+        m_flames.set(col, row);
+        m_chainFlames.set(col, row);
+        Bomb *&hit = m_pendingBombs[row * m_tiles.columns() + col];
+        if (hit) {
+            m_detonations.append(hit);
+            hit = nullptr;
+        }
+    };
+    for (int head = 0; head < m_detonations.size(); ++head) {
+        Bomb *bomb = m_detonations[head];
+        detonate(bomb);
+        BlastIndex::forEachCell(bomb->blast(), ignite);
+    }
+    
+    // 砖块只会被炸掉一次，只需要检查这次新增的火焰
+    m_chainFlames.forEachSet([this](int col, int row) {
+        if (m_tiles.tileAt(col, row) != TileMap::BRICK) return;  // 跳过空地和不可破坏的墙
+        m_tiles.setTile(col, row, TileMap::EMPTY);
+        m_walkability.setTileBlocked(col, row, false);
+        m_blast.clearObstacle(col, row);
+        m_regions.openCell(col, row);
+        m_topology.openCell(col, row);
+        refreshBlasts(col, row);
+        emit blockDestroyed(col, row);
+    });
+    // 引爆改变了炸弹状态，砖块消失也会改变剩余炸弹的火焰范围
+    m_timelineDirty = true;
+}
+
+void GameEngine::refreshBlasts(int col, int row)
+{
+    // 砖块只可能是射线的终点：沿四个方向往回找被它挡住的未爆炸炸弹，重新算范围
+    // 每颗炸弹的射程不同，沿途都要看，碰到别的障碍物就停，障碍物后面的炸弹射不到这里
+    for (int dir = 0; dir < BlastIndex::DIRECTION_COUNT; ++dir) {
+        const QPoint d = BlastIndex::direction(dir);
+        for (int i = 1; ; ++i) {
+            const int c = col - d.x() * i;
+            const int r = row - d.y() * i;
+            if (!m_tiles.contains(c, r) || m_tiles.isBlocked(c, r)) break;
+            Bomb *bomb = m_pendingBombs[r * m_tiles.columns() + c];
+            if (bomb && bomb->blast().reaches(col, row)) {
+                bomb->setBlast(m_blast.blastAt(c, r, bomb->getRange()));
+            }
+        }
+    }
+}
+
+void GameEngine::detonate(Bomb *bomb)
+{
+    // 提前引爆时取消原来的引信，改为计时火焰时长
+    clearPending(bomb);
+    m_timers.cancel(bomb->timerId());
+    bomb->setTimerId(m_timers.schedule(GameConstants::EXPLOSION_TICKS, FLAME_TIMER, bomb->handle().pack()));
+    bomb->explode();
+}
+
+const DangerTimeline& GameEngine::dangerTimeline() const
+{
+    if (!m_timelineDirty) return m_timeline;
+
+    // 每个炸弹的火焰范围都已经记在炸弹上，未爆炸的随砖块消失刷新过，正在燃烧的已经固定
+    const quint64 now = m_timers.now();
+    m_fuses.resize(0);
+    for (Bomb *bomb : m_bombs.values()) {
+        if (bomb->isFinished()) continue;
+        DangerTimeline::Fuse fuse;
+        fuse.blast = bomb->blast();
+        fuse.at = now + quint64(qMax(0, m_timers.remaining(bomb->timerId())));
+        fuse.burning = bomb->isExploding();
+        m_fuses.append(fuse);
+    }
+    m_timeline.rebuild(now, m_fuses);
+    m_timelineDirty = false;
+    return m_timeline;
+}
+
+void GameEngine::pressDirection(int dx, int dy)
+{
+    // 暂停时整局冻结，输入不改变任何状态
+    if (!m_player || m_paused) return;
+    
+    m_dirX = dx;
+    m_dirY = dy;
+    interruptForTurn();
+}
+
+void GameEngine::releaseDirection(int dx, int dy)
+{
+    if (dx != 0 && m_dirX == dx) m_dirX = 0;
+    if (dy != 0 && m_dirY == dy) m_dirY = 0;
+}
+
 void GameEngine::placeBomb()
 {
-    if (!m_player) return;
+    if (!m_player || m_paused) return;
     
-    // 计算玩家覆盖最多的方格（使用像素计算重叠面积）
-    QRectF playerRect(m_player->x(), m_player->y(), Player::SIZE_PIXELS, Player::SIZE_PIXELS);
-    const int cellSizePx = Block::SIZE_PIXELS; // 32 像素
+    // 计算玩家覆盖最多的方格（定点坐标下的整数重叠面积）
+    const int cellSize = GameConstants::BLOCK_SIZE * GameConstants::SUBSTEPS_PER_UNIT;
+    const int bodySize = Player::SIZE_UNITS * GameConstants::SUBSTEPS_PER_UNIT;
+    const QPoint p = m_player->fixedPos();
 
-    int minCellX = static_cast<int>(std::floor(playerRect.left() / cellSizePx));
-    int maxCellX = static_cast<int>(std::floor((playerRect.right() - 1) / cellSizePx));
-    int minCellY = static_cast<int>(std::floor(playerRect.top() / cellSizePx));
-    int maxCellY = static_cast<int>(std::floor((playerRect.bottom() - 1) / cellSizePx));
+    int minCellX = p.x() / cellSize;
+    int maxCellX = (p.x() + bodySize - 1) / cellSize;
+    int minCellY = p.y() / cellSize;
+    int maxCellY = (p.y() + bodySize - 1) / cellSize;
 
     int bestCellX = minCellX;
     int bestCellY = minCellY;
-    qreal bestArea = -1.0;
+    int bestArea = -1;
 
     for (int cx = minCellX; cx <= maxCellX; ++cx) {
         for (int cy = minCellY; cy <= maxCellY; ++cy) {
-            QRectF cellRect(cx * cellSizePx, cy * cellSizePx, cellSizePx, cellSizePx);
-            QRectF inter = playerRect.intersected(cellRect);
-            qreal area = inter.width() * inter.height();
+            const int w = qMin(p.x() + bodySize, (cx + 1) * cellSize) - qMax(p.x(), cx * cellSize);
+            const int h = qMin(p.y() + bodySize, (cy + 1) * cellSize) - qMax(p.y(), cy * cellSize);
+            const int area = w * h;
             if (area > bestArea) {
                 bestArea = area;
                 bestCellX = cx;
@@ -230,59 +383,59 @@ void GameEngine::placeBomb()
         }
     }
 
-    // 转回逻辑单位（一个网格是 Block::SIZE_UNITS 个逻辑单位）
-    int alignedX = bestCellX * Block::SIZE_UNITS;
-    int alignedY = bestCellY * Block::SIZE_UNITS;
+    // 转回逻辑单位（一个网格是 GameConstants::BLOCK_SIZE 个逻辑单位）
+    int alignedX = bestCellX * GameConstants::BLOCK_SIZE;
+    int alignedY = bestCellY * GameConstants::BLOCK_SIZE;
     
     // 检查是否可以在此位置放置炸弹
     if (!canPlaceBomb(alignedX, alignedY)) {
         return;
     }
     
-    // 创建炸弹（初始范围上下左右各1，使用逻辑单位）
-    Bomb *bomb = new Bomb(alignedX, alignedY, 1);
-    m_scene->addItem(bomb);
-    m_bombs.append(bomb);
+    spawnBomb(alignedX, alignedY, m_player->bombRange());
+}
+
+void GameEngine::spawnBomb(int x, int y, int range)
+{
+    // 创建炸弹（火焰上下左右各 range 格，由放炸弹的玩家决定，使用逻辑单位）
+    Bomb *bomb = new Bomb(x, y, range);
+    bomb->setBlast(m_blast.blastAt(TileMap::cellOf(x), TileMap::cellOf(y), bomb->getRange()));
+    bomb->setHandle(m_bombs.insert(bomb));
+    const int slot = pendingSlot(QPoint(x, y));
+    if (slot >= 0) {
+        m_pendingBombs[slot] = bomb;
+    }
+    m_walkability.addBomb(TileMap::cellOf(x), TileMap::cellOf(y));
+    m_regions.addBlocker(TileMap::cellOf(x), TileMap::cellOf(y));
+    m_timelineDirty = true;
     
+    connect(bomb, &Bomb::explosionStarted, this, &GameEngine::onBombDetonated);
     connect(bomb, &Bomb::explosionFinished, this, &GameEngine::onBombExploded);
     
-    // 延迟爆炸（2秒后）
-    QTimer::singleShot(2000, bomb, &Bomb::explode);
+    // 引信交给时间轮，2秒后爆炸
+    bomb->setTimerId(m_timers.schedule(GameConstants::BOMB_FUSE_TICKS, FUSE_TIMER, bomb->handle().pack()));
+    emit bombPlaced(bomb);
 }
 
 bool GameEngine::isValidPosition(int x, int y) const
 {
-    // x, y是逻辑单位
-    // 检查边界
-    if (x < 0 || y < 0 || x + Player::SIZE_UNITS > m_mapWidth || y + Player::SIZE_UNITS > m_mapHeight) {
-        return false;
+    // x, y是逻辑单位，边界、方块、炸弹都已经记录在可通行位图里
+    if (m_walkability.isWalkable(x, y)) {
+        return true;
     }
-    
-    // 转换为像素进行比较
-    QRectF playerRect(x * GameConstants::UNIT_SIZE, y * GameConstants::UNIT_SIZE, 
-                      Player::SIZE_PIXELS, Player::SIZE_PIXELS);
-    
-    // 检查是否与方块碰撞
-    for (Block *block : m_blocks) {
-        QRectF blockRect(block->x(), block->y(), Block::SIZE_PIXELS, Block::SIZE_PIXELS);
-        if (playerRect.intersects(blockRect)) {
-            return false;
-        }
+    if (!m_walkability.isFreeOfBlocks(x, y)) {
+        return false;
     }
     
-    // 检查是否与炸弹碰撞
-    QRectF currentPlayerRect;
-    if (m_player) {
-        currentPlayerRect = QRectF(m_player->x(), m_player->y(), Player::SIZE_PIXELS, Player::SIZE_PIXELS);
-    }
-    for (Bomb *bomb : m_bombs) {
-        if (!bomb->isExploding()) {
-            QRectF bombRect(bomb->x(), bomb->y(), Bomb::SIZE_PIXELS, Bomb::SIZE_PIXELS);
-            // 允许玩家从自己脚下的炸弹上离开
-            if (currentPlayerRect.isValid() && currentPlayerRect.intersects(bombRect)) {
-                continue;
-            }
-            if (playerRect.intersects(bombRect)) {
+    // 只被炸弹挡住：允许玩家从自己脚下的炸弹上离开
+    const int minCol = TileMap::cellOf(x);
+    const int maxCol = TileMap::cellOf(x + Player::SIZE_UNITS - 1);
+    const int minRow = TileMap::cellOf(y);
+    const int maxRow = TileMap::cellOf(y + Player::SIZE_UNITS - 1);
+    for (int row = minRow; row <= maxRow; ++row) {
+        for (int col = minCol; col <= maxCol; ++col) {
+            if (!m_walkability.hasBomb(col, row)) continue;
+            if (!m_player || !m_player->overlaps(col * Bomb::SIZE_UNITS, row * Bomb::SIZE_UNITS, Bomb::SIZE_UNITS)) {
                 return false;
             }
         }
@@ -293,22 +446,8 @@ bool GameEngine::isValidPosition(int x, int y) const
 
 bool GameEngine::isCellWalkable(int x, int y) const
 {
-    // 边界（逻辑单位）
-    if (x < 0 || y < 0 || x + Player::SIZE_UNITS > m_mapWidth || y + Player::SIZE_UNITS > m_mapHeight) {
-        return false;
-    }
-    QRectF rect(x * GameConstants::UNIT_SIZE, y * GameConstants::UNIT_SIZE, Player::SIZE_PIXELS, Player::SIZE_PIXELS);
-    for (Block *b : m_blocks) {
-        QRectF r(b->x(), b->y(), Block::SIZE_PIXELS, Block::SIZE_PIXELS);
-        if (rect.intersects(r)) return false;
-    }
-    for (Bomb *bomb : m_bombs) {
-        if (!bomb->isExploding()) {
-            QRectF r(bomb->x(), bomb->y(), Bomb::SIZE_PIXELS, Bomb::SIZE_PIXELS);
-            if (rect.intersects(r)) return false;
-        }
-    }
-    return true;
+    // 逻辑单位，单次位测试
+    return m_walkability.isWalkable(x, y);
 }
 
 void GameEngine::tryMoveStep()
@@ -317,12 +456,11 @@ void GameEngine::tryMoveStep()
     if (!m_player->canMove()) return;
     if (m_dirX == 0 && m_dirY == 0) return;
 
-    int currentX = static_cast<int>(std::round(m_player->x() / GameConstants::UNIT_SIZE));
-    int currentY = static_cast<int>(std::round(m_player->y() / GameConstants::UNIT_SIZE));
+    const QPoint current = m_player->getPosition();
     // 每次移动1个逻辑单位（1/4格 = 8像素）
     int stepUnits = GameConstants::LOGIC_UNIT;
-    int newX = currentX + m_dirX * stepUnits;
-    int newY = currentY + m_dirY * stepUnits;
+    int newX = current.x() + m_dirX * stepUnits;
+    int newY = current.y() + m_dirY * stepUnits;
 
     if (!isValidPosition(newX, newY)) return;
 
@@ -354,132 +492,98 @@ void GameEngine::interruptForTurn()
 
 bool GameEngine::canPlaceBomb(int x, int y) const
 {
-    // x, y是逻辑单位，需要转换为像素进行比较
-    int bombX_pixels = x * GameConstants::UNIT_SIZE;
-    int bombY_pixels = y * GameConstants::UNIT_SIZE;
-    
-    // 检查该位置是否已有炸弹
-    for (Bomb *bomb : m_bombs) {
-        if (!bomb->isExploding()) {
-            int bombX = static_cast<int>(bomb->x());
-            int bombY = static_cast<int>(bomb->y());
-            if (bombX == bombX_pixels && bombY == bombY_pixels) {
-                return false;
-            }
-        }
+    // 检查该位置是否已有未爆炸的炸弹（x, y是逻辑单位），按方格直接查表
+    const int slot = pendingSlot(QPoint(x, y));
+    if (slot < 0) return true;
+    const Bomb *bomb = m_pendingBombs[slot];
+    return !bomb || bomb->getBombPosition() != QPoint(x, y);
+}
+
+int GameEngine::pendingSlot(const QPoint &pos) const
+{
+    const int col = TileMap::cellOf(pos.x());
+    const int row = TileMap::cellOf(pos.y());
+    return m_tiles.contains(col, row) ? row * m_tiles.columns() + col : -1;
+}
+
+void GameEngine::clearPending(const Bomb *bomb)
+{
+    const int slot = pendingSlot(bomb->getBombPosition());
+    if (slot >= 0 && m_pendingBombs[slot] == bomb) {
+        m_pendingBombs[slot] = nullptr;
     }
-    return true;
+}
+
+void GameEngine::onBombDetonated(Bomb *bomb)
+{
+    // 正在爆炸的炸弹不再阻挡移动
+    if (!bomb) return;
+    const QPoint pos = bomb->getBombPosition();
+    m_walkability.removeBomb(TileMap::cellOf(pos.x()), TileMap::cellOf(pos.y()));
+    m_regions.removeBlocker(TileMap::cellOf(pos.x()), TileMap::cellOf(pos.y()));
 }
 
 void GameEngine::onBombExploded(Bomb *bomb)
 {
+    // 火焰熄灭，伤害已经在火焰存在期间逐 tick 结算过
     if (!bomb) return;
-    
-    // 获取爆炸范围
-    QList<QPoint> explosionPositions = bomb->getExplosionPositions();
-    
-    // 检查玩家是否在爆炸范围内（检查玩家矩形是否与爆炸位置重叠）
-    // explosionPositions是逻辑单位，需要转换为像素
-    if (m_player) {
-        QRectF playerRect(m_player->x(), m_player->y(), Player::SIZE_PIXELS, Player::SIZE_PIXELS);
-        for (const QPoint &expPos : explosionPositions) {
-            // expPos是逻辑单位，转换为像素
-            QRectF expRect(expPos.x() * GameConstants::UNIT_SIZE, 
-                          expPos.y() * GameConstants::UNIT_SIZE, 
-                          Block::SIZE_PIXELS, Block::SIZE_PIXELS);
-            if (playerRect.intersects(expRect)) {
-                emit gameOver();
-                // 移除炸弹
-                m_bombs.removeAll(bomb);
-                if (m_scene) {
-                    m_scene->removeItem(bomb);
-                }
-                bomb->deleteLater();
-                return;
-            }
-        }
-    }
-    
-    // 检查AI机器人是否在爆炸范围内
-    if (m_botManager) {
-        // 获取当前所有AI机器人
-        QList<Player*> bots = m_botManager->getBots(); // 假设GameBotManager有这个方法
-        QList<Player*> botsToRemove;
-        
-        for (Player *bot : bots) {
-            if (!bot) continue;
-            
-            QRectF botRect(bot->x(), bot->y(), Player::SIZE_PIXELS, Player::SIZE_PIXELS);
-            for (const QPoint &expPos : explosionPositions) {
-                QRectF expRect(expPos.x() * GameConstants::UNIT_SIZE,
-                              expPos.y() * GameConstants::UNIT_SIZE,
-                              Block::SIZE_PIXELS, Block::SIZE_PIXELS);
-                if (botRect.intersects(expRect)) {
-                    // 机器人被炸到，标记为移除
-                    botsToRemove.append(bot);
-                    break; // 一旦发现机器人在爆炸范围内，跳出内循环
-                }
-            }
-        }
-        
-        // 从场景中移除被炸死的机器人
-        for (Player *bot : botsToRemove) {
-            if (m_scene) {
-                m_scene->removeItem(bot);
-            }
-            // 从bot管理器中移除机器人
-            m_botManager->removeBot(bot);
-            bot->deleteLater();
-        }
-    }
-    
-    // 销毁范围内的方块
-    destroyBlocksInRange(explosionPositions);
-    
-    // 移除炸弹
-    m_bombs.removeAll(bomb);
-    if (m_scene) {
-        m_scene->removeItem(bomb);
-    }
+    m_flamesDirty = true;
+    removeBomb(bomb);
+}
+
+void GameEngine::removeBomb(Bomb *bomb)
+{
+    clearPending(bomb);
+    m_timers.cancel(bomb->timerId());
+    m_bombs.remove(bomb->handle());
+    m_timelineDirty = true;
+    emit bombRemoved(bomb);
     bomb->deleteLater();
 }
 
-void GameEngine::destroyBlocksInRange(const QList<QPoint> &explosionPositions)
+void GameEngine::rebuildFlames()
 {
-    QList<Block*> toRemove;
-    
-    for (Block *block : m_blocks) {
-        if (!block->isDestructible()) {
-            continue;  // 跳过不可破坏的墙
-        }
-        
-        // 使用像素矩形做交集判断，避免精度和对齐误差
-        QRectF blockRect(block->x(), block->y(), Block::SIZE_PIXELS, Block::SIZE_PIXELS);
-        for (const QPoint &expPos : explosionPositions) {
-            QRectF expRect(expPos.x() * GameConstants::UNIT_SIZE,
-                          expPos.y() * GameConstants::UNIT_SIZE,
-                          Block::SIZE_PIXELS, Block::SIZE_PIXELS);
-            if (blockRect.intersects(expRect)) {
-                toRemove.append(block);
-                break;  // 找到匹配就跳出内层循环
+    // 所有仍在燃烧的炸弹一起光栅化到方格位图
+    m_flames.clear();
+    for (Bomb *bomb : m_bombs.values()) {
+        if (!bomb->isExploding() || bomb->isFinished()) continue;
+        const BlastIndex::Blast &blast = bomb->blast();
+        m_flames.set(blast.col, blast.row);
+        for (int dir = 0; dir < BlastIndex::DIRECTION_COUNT; ++dir) {
+            const QPoint d = BlastIndex::direction(dir);
+            for (int i = 1; i <= blast.arms[dir].length; ++i) {
+                m_flames.set(blast.col + d.x() * i, blast.row + d.y() * i);
             }
         }
     }
+    m_flamesDirty = false;
+}
+
+void GameEngine::resolveFlameDamage()
+{
+    // 每个实体只查它压到的最多 2x2 个方格
+    if (m_player && !m_gameOver && isInFlames(m_player)) {
+        m_gameOver = true;
+        emit gameOver();
+    }
     
-    for (Block *block : toRemove) {
-        m_blocks.removeAll(block);
-        if (m_scene) {
-            m_scene->removeItem(block);
+    if (m_botManager) {
+        const QVector<Player*> bots = m_botManager->getBots();  // 移除机器人会改动原数组
+        for (Player *bot : bots) {
+            if (!isInFlames(bot)) continue;
+            // 机器人被炸到，从bot管理器中移除
+            m_botManager->removeBot(bot);
+            bot->deleteLater();
         }
-        delete block;
     }
 }
 
-bool GameEngine::isPositionInList(const QPoint &pos, const QList<QPoint> &list) const
+bool GameEngine::isInFlames(const Player *player) const
 {
-    for (const QPoint &p : list) {
-        if (p.x() == pos.x() && p.y() == pos.y()) {
-            return true;
+    const QRect cells = player->coveredCells();
+    for (int row = cells.top(); row <= cells.bottom(); ++row) {
+        for (int col = cells.left(); col <= cells.right(); ++col) {
+            if (m_flames.test(col, row)) return true;
         }
     }
     return false;
@@ -487,14 +591,10 @@ bool GameEngine::isPositionInList(const QPoint &pos, const QList<QPoint> &list)
 
 void GameEngine::stopGame()
 {
+    // 冻结整局：之后的 tick() 直接返回，引信、火焰和机器人都不再推进
+    m_paused = true;
     m_dirX = 0;
     m_dirY = 0;
-    if (m_moveTimer) {
-        m_moveTimer->stop();
-    }
-    if (m_botTimer) {
-        m_botTimer->stop();
-    }
     if (m_player) {
         m_player->interruptMove();
         m_player->setCanMove(false);
@@ -504,13 +604,9 @@ void GameEngine::stopGame()
     }
 }
 
-bool GameEngine::createBombAtCell(int x, int y)
+bool GameEngine::createBombAtCell(int x, int y, int range)
 {
     if (!canPlaceBomb(x, y)) return false;
-    Bomb *bomb = new Bomb(x, y, 1);
-    m_scene->addItem(bomb);
-    m_bombs.append(bomb);
-    connect(bomb, &Bomb::explosionFinished, this, &GameEngine::onBombExploded);
-    QTimer::singleShot(2000, bomb, &Bomb::explode);
+    spawnBomb(x, y, range);
     return true;
 }
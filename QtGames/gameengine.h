@@ -2,52 +2,89 @@
 #define GAMEENGINE_H
 
 #include <QObject>
-#include <QTimer>
 #include <QList>
 #include <QPoint>
+#include <QRandomGenerator>
 #include "player.h"
 #include "bomb.h"
-#include "block.h"
+#include "tilemap.h"
+#include "walkabilitymap.h"
+#include "timerwheel.h"
+#include "gridbitset.h"
+#include "blastindex.h"
+#include "dangertimeline.h"
+#include "cellregions.h"
+#include "maptopology.h"
+#include "slotmap.h"
 #include "gameconstants.h"
 
-class QGraphicsScene;
 class GameBotManager;
 
+// 游戏规则与世界状态（地图、玩家、炸弹、机器人），不依赖图形界面
+// 渲染层通过信号同步显示，可在无显示环境下独立运行
 class GameEngine : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit GameEngine(QGraphicsScene *scene, QObject *parent = nullptr);
+    explicit GameEngine(QObject *parent = nullptr);
     ~GameEngine();
     
     void initializeGame();
-    void handleKeyPress(QKeyEvent *event);
-    void handleKeyRelease(QKeyEvent *event);
+    void setSeed(quint32 seed) { m_rng.seed(seed); }  // 固定种子可复现同一张地图
+    
+    // 固定步长推进：每个 tick 依次处理移动、玩家输入、机器人决策、炸弹引信与爆炸
+    void tick();
+    void advance(int ticks);  // 无界面模式下连续推进，不受真实时间限制
+    quint64 tickCount() const { return m_tick; }
+    // 暂停时 tick() 直接返回，时间轮不前进，所有引信和火焰一起冻结
+    void setPaused(bool paused) { m_paused = paused; }
+    bool isPaused() const { return m_paused; }
+    // 定时器时钟：引信到期和危险时间线都以它为基准
+    quint64 timerNow() const { return m_timers.now(); }
+    // 每个方格的火焰时间窗（含连锁引爆），炸弹或地形变化后第一次查询时重建
+    const DangerTimeline& dangerTimeline() const;
+    // 输入：方向键按下/松开（dx, dy 取 -1/0/1）
+    void pressDirection(int dx, int dy);
+    void releaseDirection(int dx, int dy);
     void placeBomb();
-    void stopGame();  // 停止移动并发出结束信号
+    void stopGame();  // 暂停并停止所有移动，重新 initializeGame() 之前不再推进
     // 供 BotManager 调用
-    bool createBombAtCell(int x, int y);
+    bool createBombAtCell(int x, int y, int range);
     bool isCellWalkable(int x, int y) const;
     
     Player* getPlayer() const { return m_player; }
-    const QList<Block*>& blocks() const { return m_blocks; }
-    const QList<Bomb*>& bombs() const { return m_bombs; }
-    QGraphicsScene* scene() const { return m_scene; }
+    const QVector<Player*>& bots() const;
+    const TileMap& tileMap() const { return m_tiles; }
+    const WalkabilityMap& walkability() const { return m_walkability; }
+    const QVector<Bomb*>& bombs() const { return m_bombs.values(); }
+    const BlastIndex& blastIndex() const { return m_blast; }
+    const CellRegions& regions() const { return m_regions; }  // 方格连通性，含炸弹覆盖层
+    const MapTopology& topology() const { return m_topology; }  // 死胡同、割点和口袋，只看地形
     int mapWidth() const { return m_mapWidth; }
     int mapHeight() const { return m_mapHeight; }
 
 signals:
     void gameOver();
+    void mapLoaded();                       // 地图重建完成，渲染层据此重建方块
+    void blockDestroyed(int col, int row);  // 方格坐标
+    void playerAdded(Player *player);       // 玩家或机器人加入
+    void playerRemoved(Player *player);     // 发出后对象会被释放
+    void bombPlaced(Bomb *bomb);
+    void bombRemoved(Bomb *bomb);           // 发出后对象会被释放
 
 private slots:
+    void onBombDetonated(Bomb *bomb);
     void onBombExploded(Bomb *bomb);
 
 private:
-    QGraphicsScene *m_scene;
     Player *m_player;
-    QList<Bomb*> m_bombs;
-    QList<Block*> m_blocks;
+    SlotMap<Bomb*> m_bombs;
+    TileMap m_tiles;  // 地图的唯一数据源
+    WalkabilityMap m_walkability;  // 玩家体积的可通行位图，随砖块/炸弹变化局部更新
+    BlastIndex m_blast;  // 行/列空地段，用于计算火焰被墙和砖块挡住的位置
+    CellRegions m_regions;  // 空地方格的连通区域，砖块被炸掉时合并
+    MapTopology m_topology;  // 空地方格图的拓扑，砖块被炸掉时更新
     class GameBotManager *m_botManager;
     
     int m_mapWidth;
@@ -56,15 +93,43 @@ private:
     int m_dirY;
     int m_lastMoveX;
     int m_lastMoveY;
-    QTimer *m_moveTimer;
-    QTimer *m_botTimer;
+    quint64 m_tick;
+    bool m_paused;
+    bool m_gameOver;  // gameOver 每局只发一次
+    TimerWheel m_timers;  // 所有炸弹的引信和火焰到期时间
+    QVector<TimerWheel::Expired> m_expired;  // 复用的到期列表
+    GridBitset m_flames;       // 当前所有火焰覆盖的方格
+    GridBitset m_chainFlames;  // 本 tick 连锁新增的火焰，用来炸砖块
+    bool m_flamesDirty;        // 有火焰熄灭，需要重新光栅化
+    QVector<Bomb*> m_detonations;   // 本 tick 的引爆队列，连锁引爆的炸弹追加在后面
+    QVector<Bomb*> m_pendingBombs;  // 每个方格上未爆炸的炸弹
+    mutable DangerTimeline m_timeline;
+    mutable QVector<DangerTimeline::Fuse> m_fuses;  // 重建时间线用的输入，复用
+    mutable bool m_timelineDirty;
+    QRandomGenerator m_rng;
+    
+    enum TimerKind : quint32 {
+        FUSE_TIMER,   // 引信燃尽，炸弹爆炸
+        FLAME_TIMER   // 火焰熄灭，结算伤害并移除炸弹
+    };
     
+    void clearWorld();
     void createMap();
+    void validateMap() const;
+    void addBlock(int x, int y, TileMap::Tile type);
     bool isValidPosition(int x, int y) const;
     bool canPlaceBomb(int x, int y) const;
-    void checkCollisions();
-    void destroyBlocksInRange(const QList<QPoint> &explosionPositions);
-    bool isPositionInList(const QPoint &pos, const QList<QPoint> &list) const;
+    void spawnBomb(int x, int y, int range);
+    void removeBomb(Bomb *bomb);
+    void advanceBombs();
+    void resolveDetonations();
+    void detonate(Bomb *bomb);
+    void refreshBlasts(int col, int row);  // 砖块被炸掉后刷新射线被它挡住的未爆炸炸弹
+    int pendingSlot(const QPoint &pos) const;  // 方格下标，地图外返回 -1
+    void clearPending(const Bomb *bomb);
+    void rebuildFlames();
+    void resolveFlameDamage();
+    bool isInFlames(const Player *player) const;
     void tryMoveStep();
     void interruptForTurn();
 };
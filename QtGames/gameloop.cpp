@@ -0,0 +1,48 @@
+#include "gameloop.h"
+#include "gameengine.h"
+#include "gameconstants.h"
+
+GameLoop::GameLoop(GameEngine *engine, QObject *parent)
+    : QObject(parent)
+    , m_engine(engine)
+    , m_timer(new QTimer(this))
+    , m_lastMs(0)
+    , m_accumulatedMs(0)
+{
+    m_timer->setTimerType(Qt::PreciseTimer);
+    m_timer->setInterval(GameConstants::TICK_MS);
+    connect(m_timer, &QTimer::timeout, this, &GameLoop::onTimeout);
+}
+
+void GameLoop::start()
+{
+    m_clock.start();
+    m_lastMs = 0;
+    m_accumulatedMs = 0;
+    m_timer->start();
+}
+
+void GameLoop::stop()
+{
+    m_timer->stop();
+}
+
+void GameLoop::onTimeout()
+{
+    if (!m_engine) return;
+    
+    const qint64 now = m_clock.elapsed();
+    m_accumulatedMs += now - m_lastMs;
+    m_lastMs = now;
+    
+    int ticks = 0;
+    while (m_accumulatedMs >= GameConstants::TICK_MS && ticks < MAX_CATCH_UP_TICKS) {
+        m_engine->tick();
+        m_accumulatedMs -= GameConstants::TICK_MS;
+        ++ticks;
+    }
+    // 追不上的部分直接丢弃，只保留不足一个 tick 的余量
+    if (m_accumulatedMs >= GameConstants::TICK_MS) {
+        m_accumulatedMs %= GameConstants::TICK_MS;
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef GAMELOOP_H
+#define GAMELOOP_H
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+
+class GameEngine;
+
+// 固定步长驱动器：按真实时间累积，每满 TICK_MS 推进引擎一个 tick
+// 追帧策略：单次唤醒最多补 MAX_CATCH_UP_TICKS 个 tick，超出的积压直接丢弃，
+// 负载过高时游戏整体变慢，而不会一次跳过很多 tick 导致结果与正常速度不同
+class GameLoop : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit GameLoop(GameEngine *engine, QObject *parent = nullptr);
+    
+    void start();
+    void stop();
+    bool isRunning() const { return m_timer->isActive(); }
+    
+    static const int MAX_CATCH_UP_TICKS = 5;
+
+private slots:
+    void onTimeout();
+
+private:
+    GameEngine *m_engine;
+    QTimer *m_timer;
+    QElapsedTimer m_clock;
+    qint64 m_lastMs;
+    qint64 m_accumulatedMs;
+};
+
+#endif // GAMELOOP_H
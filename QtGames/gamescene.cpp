@@ -1,24 +1,40 @@
 #include "gamescene.h"
 #include "gameengine.h"
+#include "gameloop.h"
 #include "gameconstants.h"
+#include "block.h"
+#include "playeritem.h"
+#include "bombitem.h"
 #include <QKeyEvent>
 #include <QMessageBox>
 
 GameScene::GameScene(QObject *parent)
     : QGraphicsScene(parent)
     , m_gameEngine(nullptr)
+    , m_gameLoop(nullptr)
 {
     // 设置场景大小（使用像素）
     setSceneRect(0, 0, GameConstants::MAP_SIZE_PIXELS, GameConstants::MAP_SIZE_PIXELS);
     
-    // 创建游戏引擎
-    m_gameEngine = new GameEngine(this, this);
+    // 创建游戏引擎和固定步长驱动器
+    m_gameEngine = new GameEngine(this);
+    m_gameLoop = new GameLoop(m_gameEngine, this);
     
-    // 连接游戏结束信号
+    // 根据引擎状态同步图元
+    connect(m_gameEngine, &GameEngine::mapLoaded, this, &GameScene::rebuildBlocks);
+    connect(m_gameEngine, &GameEngine::blockDestroyed, this, &GameScene::removeBlockItem);
+    connect(m_gameEngine, &GameEngine::playerAdded, this, &GameScene::addPlayerItem);
+    connect(m_gameEngine, &GameEngine::playerRemoved, this, &GameScene::removePlayerItem);
+    connect(m_gameEngine, &GameEngine::bombPlaced, this, &GameScene::addBombItem);
+    connect(m_gameEngine, &GameEngine::bombRemoved, this, &GameScene::removeBombItem);
+    
+    // 连接游戏结束信号：gameOver 在 tick() 里发出，排队到 tick 结束后再处理，
+    // 先停掉驱动器和引擎，模态对话框的事件循环就不会重入 tick()
     connect(m_gameEngine, &GameEngine::gameOver, this, [this]() {
+        m_gameLoop->stop();
         m_gameEngine->stopGame();
         QMessageBox::information(nullptr, tr("游戏结束"), tr("玩家被炸到了，游戏结束！"));
-    });
+    }, Qt::QueuedConnection);
     
     // 初始化游戏
     initializeGame();
@@ -33,21 +49,144 @@ void GameScene::initializeGame()
 {
     if (m_gameEngine) {
         m_gameEngine->initializeGame();
+        m_gameLoop->start();
     }
 }
 
 void GameScene::keyPressEvent(QKeyEvent *event)
 {
-    if (m_gameEngine) {
-        m_gameEngine->handleKeyPress(event);
+    if (!m_gameEngine) return;
+    
+    switch (event->key()) {
+    case Qt::Key_Up:
+    case Qt::Key_W:
+        m_gameEngine->pressDirection(0, -1);
+        break;
+    case Qt::Key_Down:
+    case Qt::Key_S:
+        m_gameEngine->pressDirection(0, 1);
+        break;
+    case Qt::Key_Left:
+    case Qt::Key_A:
+        m_gameEngine->pressDirection(-1, 0);
+        break;
+    case Qt::Key_Right:
+    case Qt::Key_D:
+        m_gameEngine->pressDirection(1, 0);
+        break;
+    case Qt::Key_Space:
+        m_gameEngine->placeBomb();
+        break;
+    case Qt::Key_P:
+        m_gameEngine->setPaused(!m_gameEngine->isPaused());
+        break;
     }
     // 不调用父类方法，因为我们自己处理了所有键盘事件
 }
 
 void GameScene::keyReleaseEvent(QKeyEvent *event)
 {
-    if (m_gameEngine) {
-        m_gameEngine->handleKeyRelease(event);
+    if (!m_gameEngine) return;
+    
+    switch (event->key()) {
+    case Qt::Key_Up:
+    case Qt::Key_W:
+        m_gameEngine->releaseDirection(0, -1);
+        break;
+    case Qt::Key_Down:
+    case Qt::Key_S:
+        m_gameEngine->releaseDirection(0, 1);
+        break;
+    case Qt::Key_Left:
+    case Qt::Key_A:
+        m_gameEngine->releaseDirection(-1, 0);
+        break;
+    case Qt::Key_Right:
+    case Qt::Key_D:
+        m_gameEngine->releaseDirection(1, 0);
+        break;
+    default:
+        break;
     }
     // 不调用父类方法
 }
+
+void GameScene::rebuildBlocks()
+{
+    for (Block *block : m_blockItems) {
+        if (block) {
+            removeItem(block);
+            delete block;
+        }
+    }
+    
+    const TileMap &tiles = m_gameEngine->tileMap();
+    m_blockItems.fill(nullptr, tiles.columns() * tiles.rows());
+    for (int row = 0; row < tiles.rows(); ++row) {
+        for (int col = 0; col < tiles.columns(); ++col) {
+            TileMap::Tile tile = tiles.tileAt(col, row);
+            if (tile == TileMap::EMPTY) continue;
+            // Block 使用逻辑单位坐标
+            Block *block = new Block(col * Block::SIZE_UNITS, row * Block::SIZE_UNITS,
+                                     tile == TileMap::WALL ? Block::WALL : Block::BRICK);
+            addItem(block);
+            m_blockItems[row * tiles.columns() + col] = block;
+        }
+    }
+}
+
+void GameScene::removeBlockItem(int col, int row)
+{
+    const int columns = m_gameEngine->tileMap().columns();
+    const int index = row * columns + col;
+    if (col < 0 || col >= columns || index < 0 || index >= m_blockItems.size()) return;
+    Block *block = m_blockItems[index];
+    if (!block) return;
+    m_blockItems[index] = nullptr;
+    removeItem(block);
+    delete block;
+}
+
+void GameScene::addPlayerItem(Player *player)
+{
+    PlayerItem *item = new PlayerItem(player);
+    addItem(item);
+    m_playerItems.insert(player, item);
+    connect(player, &Player::positionChanged, this, [item, player]() {
+        item->syncPosition(player);
+    });
+}
+
+void GameScene::removePlayerItem(Player *player)
+{
+    PlayerItem *item = m_playerItems.take(player);
+    // 对象释放前可能还有动画帧，先断开位置同步
+    disconnect(player, nullptr, this, nullptr);
+    if (item) {
+        removeItem(item);
+        delete item;
+    }
+}
+
+void GameScene::addBombItem(Bomb *bomb)
+{
+    BombItem *item = new BombItem(bomb);
+    addItem(item);
+    m_bombItems.insert(bomb, item);
+    connect(bomb, &Bomb::explosionStarted, this, [item](Bomb *b) {
+        item->showExplosion(b->getExplosionPositions());
+    });
+    connect(bomb, &Bomb::explosionFinished, this, [item]() {
+        item->clearExplosion();
+    });
+}
+
+void GameScene::removeBombItem(Bomb *bomb)
+{
+    BombItem *item = m_bombItems.take(bomb);
+    disconnect(bomb, nullptr, this, nullptr);
+    if (item) {
+        removeItem(item);
+        delete item;
+    }
+}
@@ -3,9 +3,18 @@
 
 #include <QGraphicsScene>
 #include <QKeyEvent>
+#include <QHash>
+#include <QVector>
 
 class GameEngine;
+class GameLoop;
+class Player;
+class Bomb;
+class Block;
+class PlayerItem;
+class BombItem;
 
+// 渲染/输入适配层：把键盘事件交给游戏引擎，并根据引擎的信号同步图元
 class GameScene : public QGraphicsScene
 {
     Q_OBJECT
@@ -20,6 +29,17 @@ public:
 
 private:
     GameEngine *m_gameEngine;
+    GameLoop *m_gameLoop;
+    QVector<Block*> m_blockItems;  // 按方格索引，空地为 nullptr
+    QHash<Player*, PlayerItem*> m_playerItems;
+    QHash<Bomb*, BombItem*> m_bombItems;
+    
+    void rebuildBlocks();
+    void removeBlockItem(int col, int row);
+    void addPlayerItem(Player *player);
+    void removePlayerItem(Player *player);
+    void addBombItem(Bomb *bomb);
+    void removeBombItem(Bomb *bomb);
 };
 
 #endif // GAMESCENE_H
@@ -0,0 +1,140 @@
+#ifndef GRIDBITSET_H
+#define GRIDBITSET_H
+
+#include <QVector>
+#include <QtAlgorithms>
+#include <QtGlobal>
+
+// 二维位图：每行按 64 位字对齐存储，越界读取一律返回 false
+// 行尾多出来的位始终保持为 0，保证 count()/any() 的结果正确
+class GridBitset
+{
+public:
+    GridBitset(int width = 0, int height = 0) { resize(width, height); }
+
+    void resize(int width, int height) {
+        m_width = width;
+        m_height = height;
+        m_wordsPerRow = (width + 63) / 64;
+        m_words.fill(0, m_wordsPerRow * height);
+    }
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    bool contains(int x, int y) const {
+        return x >= 0 && y >= 0 && x < m_width && y < m_height;
+    }
+
+    bool test(int x, int y) const {
+        if (!contains(x, y)) return false;
+        return (m_words[y * m_wordsPerRow + (x >> 6)] >> (x & 63)) & 1;
+    }
+    void set(int x, int y) {
+        if (contains(x, y)) m_words[y * m_wordsPerRow + (x >> 6)] |= bit(x);
+    }
+    void reset(int x, int y) {
+        if (contains(x, y)) m_words[y * m_wordsPerRow + (x >> 6)] &= ~bit(x);
+    }
+    void assign(int x, int y, bool value) {
+        if (value) set(x, y); else reset(x, y);
+    }
+
+    // 把矩形 [x, x + w) x [y, y + h) 全部置位，超出边界的部分裁掉；每行按整字写入
+    void fillRect(int x, int y, int w, int h) {
+        const int x0 = qMax(x, 0);
+        const int x1 = qMin(x + w, m_width);  // 不含
+        const int y0 = qMax(y, 0);
+        const int y1 = qMin(y + h, m_height);
+        if (x0 >= x1 || y0 >= y1) return;
+        const int firstWord = x0 >> 6;
+        const int lastWord = (x1 - 1) >> 6;
+        for (int row = y0; row < y1; ++row) {
+            quint64 *words = m_words.data() + row * m_wordsPerRow;
+            for (int word = firstWord; word <= lastWord; ++word) {
+                const int lo = word == firstWord ? (x0 & 63) : 0;
+                const int hi = word == lastWord ? ((x1 - 1) & 63) : 63;
+                const quint64 upper = hi == 63 ? ~quint64(0) : ((quint64(1) << (hi + 1)) - 1);
+                words[word] |= upper & ~((quint64(1) << lo) - 1);
+            }
+        }
+    }
+
+    void clear() { m_words.fill(0); }
+    void fill(bool value) {
+        if (!value) {
+            clear();
+            return;
+        }
+        for (int y = 0; y < m_height; ++y) {
+            for (int w = 0; w < m_wordsPerRow; ++w) {
+                m_words[y * m_wordsPerRow + w] = wordMask(w);
+            }
+        }
+    }
+
+    // 整字运算，要求两个位图尺寸一致
+    GridBitset &operator|=(const GridBitset &other) {
+        for (int i = 0; i < m_words.size(); ++i) m_words[i] |= other.m_words[i];
+        return *this;
+    }
+    GridBitset &operator&=(const GridBitset &other) {
+        for (int i = 0; i < m_words.size(); ++i) m_words[i] &= other.m_words[i];
+        return *this;
+    }
+    GridBitset &subtract(const GridBitset &other) {
+        for (int i = 0; i < m_words.size(); ++i) m_words[i] &= ~other.m_words[i];
+        return *this;
+    }
+    bool intersects(const GridBitset &other) const {
+        for (int i = 0; i < m_words.size(); ++i) {
+            if (m_words[i] & other.m_words[i]) return true;
+        }
+        return false;
+    }
+
+    bool any() const {
+        for (quint64 word : m_words) {
+            if (word) return true;
+        }
+        return false;
+    }
+    int count() const {
+        int n = 0;
+        for (quint64 word : m_words) n += qPopulationCount(word);
+        return n;
+    }
+
+    // 按行优先顺序遍历所有置位的格子，f(x, y)
+    template <typename F>
+    void forEachSet(F f) const {
+        for (int y = 0; y < m_height; ++y) {
+            for (int w = 0; w < m_wordsPerRow; ++w) {
+                quint64 word = m_words[y * m_wordsPerRow + w];
+                while (word) {
+                    const int x = (w << 6) + qCountTrailingZeroBits(word);
+                    f(x, y);
+                    word &= word - 1;
+                }
+            }
+        }
+    }
+
+    bool operator==(const GridBitset &other) const {
+        return m_width == other.m_width && m_height == other.m_height && m_words == other.m_words;
+    }
+    bool operator!=(const GridBitset &other) const { return !(*this == other); }
+
+private:
+    int m_width = 0;
+    int m_height = 0;
+    int m_wordsPerRow = 0;
+    QVector<quint64> m_words;
+
+    static quint64 bit(int x) { return quint64(1) << (x & 63); }
+    quint64 wordMask(int w) const {
+        const int bits = m_width - (w << 6);
+        return bits >= 64 ? ~quint64(0) : ((quint64(1) << bits) - 1);
+    }
+};
+
+#endif // GRIDBITSET_H
@@ -0,0 +1,39 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+#include "gameengine.h"
+
+// 无界面对局：不等待真实时间，尽可能快地推进 tick，用于服务器对局和引擎性能测试
+// 用法：QtGamesHeadless [最大tick数] [随机种子]
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = QCoreApplication::arguments();
+    const int maxTicks = args.size() > 1 ? args.at(1).toInt() : 60 * 1000 / GameConstants::TICK_MS;
+    const quint32 seed = args.size() > 2 ? args.at(2).toUInt() : 1;
+
+    GameEngine engine;
+    bool over = false;
+    QObject::connect(&engine, &GameEngine::gameOver, &engine, [&over]() { over = true; });
+    engine.setSeed(seed);
+    engine.initializeGame();
+
+    QElapsedTimer clock;
+    clock.start();
+    while (!over && engine.tickCount() < quint64(maxTicks)) {
+        engine.tick();
+        // 没有事件循环，手动释放本 tick 里被炸死的机器人
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    }
+    const qint64 elapsedNs = clock.nsecsElapsed();
+
+    QTextStream out(stdout);
+    out << "seed " << seed
+        << " ticks " << engine.tickCount()
+        << " bots " << engine.bots().size()
+        << " player " << (over ? "dead" : "alive")
+        << " time " << elapsedNs / 1000000.0 << "ms"
+        << " (" << (elapsedNs > 0 ? engine.tickCount() * 1e9 / elapsedNs : 0.0) << " ticks/s)\n";
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include "jumppointsearch.h"
+#include <algorithm>
+
+void JumpPointSearch::begin(int width, int height)
+{
+    if (width != m_width || height != m_height) {
+        m_width = width;
+        m_height = height;
+        const int cells = width * height;
+        m_stamp.fill(0, cells);
+        m_g.resize(cells);
+        m_parent.resize(cells);
+        m_epoch = 0;
+    }
+    if (++m_epoch == 0) {
+        // 轮次回绕后旧标记可能与新轮次冲突，只有这时才真正清空
+        m_stamp.fill(0);
+        m_epoch = 1;
+    }
+    m_open.resize(0);
+}
+
+void JumpPointSearch::push(int node, int parent, int g)
+{
+    if (m_stamp[node] == m_epoch && m_g[node] <= g) return;
+    m_stamp[node] = m_epoch;
+    m_g[node] = g;
+    m_parent[node] = parent;
+
+    // 上浮
+    Entry entry = { g + heuristic(node), g, node };
+    int i = m_open.size();
+    m_open.append(entry);
+    while (i > 0) {
+        const int up = (i - 1) / 2;
+        const Entry &above = m_open[up];
+        if (above.f < entry.f || (above.f == entry.f && above.g >= entry.g)) break;
+        m_open[i] = above;
+        i = up;
+    }
+    m_open[i] = entry;
+}
+
+JumpPointSearch::Entry JumpPointSearch::pop()
+{
+    const Entry top = m_open.first();
+    const Entry last = m_open.last();
+    m_open.removeLast();
+    const int size = m_open.size();
+    if (size == 0) return top;
+
+    // 末尾的项放到堆顶再下沉
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= size) break;
+        if (child + 1 < size) {
+            const Entry &a = m_open[child];
+            const Entry &b = m_open[child + 1];
+            if (b.f < a.f || (b.f == a.f && b.g > a.g)) ++child;
+        }
+        const Entry &below = m_open[child];
+        if (last.f < below.f || (last.f == below.f && last.g >= below.g)) break;
+        m_open[i] = below;
+        i = child;
+    }
+    m_open[i] = last;
+    return top;
+}
+
+int JumpPointSearch::heuristic(int node) const
+{
+    return qAbs(node % m_width - m_goal % m_width) + qAbs(node / m_width - m_goal / m_width);
+}
+
+void JumpPointSearch::trace(int start, int node, QVector<QPoint> &path) const
+{
+    // 相邻两个跳点在同一条直线上，从终点倒着逐格走回起点，最后反转
+    path.resize(0);
+    QPoint cur(node % m_width, node / m_width);
+    path.append(cur);
+    while (node != start) {
+        node = m_parent[node];
+        const QPoint to(node % m_width, node / m_width);
+        const QPoint d(qBound(-1, to.x() - cur.x(), 1), qBound(-1, to.y() - cur.y(), 1));
+        while (cur != to) {
+            cur += d;
+            path.append(cur);
+        }
+    }
+    std::reverse(path.begin(), path.end());
+}
@@ -0,0 +1,136 @@
+#ifndef JUMPPOINTSEARCH_H
+#define JUMPPOINTSEARCH_H
+
+#include <QPoint>
+#include <QVector>
+#include <QtGlobal>
+
+// 四连通、代价一致的网格上的跳点搜索（JPS）：同样长的路线里只保留“先竖走、再横走”的那一条
+// 横向沿直线一路跳到出现被迫邻居（身后那格的上/下被挡住、这一格的上/下却能走）为止，
+// 竖向每走一步都向左右各横扫一次，扫到跳点才停下；只有跳点进开放表，按 A*（曼哈顿距离）展开
+// 开阔地带里展开的节点只有逐格 BFS 的零头。访问标记用轮次，开放表是复用的二叉堆，不做堆分配
+// 不预先算跳跃距离：可通行由调用方实时给出（会叠加随时变化的危险区），砖块被炸掉后自然生效
+class JumpPointSearch
+{
+public:
+    // passable(x, y) 决定位置能否经过（起点本身不查），地图外一律不能走
+    // 找到时 path 是从 start 到 goal 逐格的最短路线（含两端），到不了 goal 时返回 false
+    template <typename Passable>
+    bool findPath(int width, int height, const QPoint &start, const QPoint &goal, Passable passable, QVector<QPoint> &path);
+
+private:
+    struct Entry {
+        int f;
+        int g;
+        int node;
+    };
+
+    int m_width = 0;
+    int m_height = 0;
+    int m_goal = -1;
+    quint32 m_epoch = 0;
+    QVector<quint32> m_stamp;  // 等于当前轮次表示本次已经有 g 值
+    QVector<qint32> m_g;
+    QVector<qint32> m_parent;  // 上一个跳点，两者在同一条直线上
+    QVector<Entry> m_open;     // 二叉小顶堆，f 相同时 g 大的优先
+
+    void begin(int width, int height);
+    void push(int node, int parent, int g);
+    Entry pop();
+    int heuristic(int node) const;
+    void trace(int start, int node, QVector<QPoint> &path) const;  // 沿跳点回溯，逐格补齐
+
+    template <typename Passable>
+    bool open(int x, int y, Passable &passable) const {
+        return x >= 0 && y >= 0 && x < m_width && y < m_height && passable(x, y);
+    }
+    // 从 (x, y) 沿一个方向跳，返回跳点下标，撞墙时为 -1
+    template <typename Passable>
+    int jumpHorizontal(int x, int y, int dx, Passable &passable) const;
+    template <typename Passable>
+    int jumpVertical(int x, int y, int dy, Passable &passable) const;
+};
+
+template <typename Passable>
+bool JumpPointSearch::findPath(int width, int height, const QPoint &start, const QPoint &goal, Passable passable, QVector<QPoint> &path)
+{
+    if (start == goal) {
+        path.resize(0);
+        path.append(start);
+        return true;
+    }
+    begin(width, height);
+    const bool inside = start.x() >= 0 && start.y() >= 0 && start.x() < width && start.y() < height;
+    if (!inside || !open(goal.x(), goal.y(), passable)) return false;
+    const int source = start.y() * width + start.x();
+    m_goal = goal.y() * width + goal.x();
+    push(source, source, 0);
+
+    while (!m_open.isEmpty()) {
+        const Entry entry = pop();
+        if (entry.g != m_g[entry.node]) continue;  // 已经有更短的路线，旧的堆项作废
+        if (entry.node == m_goal) {
+            trace(source, m_goal, path);
+            return true;
+        }
+
+        const int node = entry.node;
+        const int x = node % width;
+        const int y = node / width;
+        const int parent = m_parent[node];
+        const int px = parent % width;
+        const int py = parent / width;
+        // 后继：起点四个方向都跳；竖着到达的继续竖走并向两侧横走；
+        // 横着到达的继续横走，上/下只在被迫时才转过去
+        int next[4];
+        int count = 0;
+        if (node == source || px == x) {
+            const int dy = y - py;
+            if (dy >= 0) next[count++] = jumpVertical(x, y, 1, passable);
+            if (dy <= 0) next[count++] = jumpVertical(x, y, -1, passable);
+            next[count++] = jumpHorizontal(x, y, 1, passable);
+            next[count++] = jumpHorizontal(x, y, -1, passable);
+        } else {
+            const int dx = x > px ? 1 : -1;
+            next[count++] = jumpHorizontal(x, y, dx, passable);
+            if (open(x, y - 1, passable) && !open(x - dx, y - 1, passable)) next[count++] = jumpVertical(x, y, -1, passable);
+            if (open(x, y + 1, passable) && !open(x - dx, y + 1, passable)) next[count++] = jumpVertical(x, y, 1, passable);
+        }
+        for (int i = 0; i < count; ++i) {
+            const int jump = next[i];
+            if (jump < 0) continue;
+            // 跳点和当前节点在同一条直线上，代价就是坐标差
+            const int cost = qAbs(jump % width - x) + qAbs(jump / width - y);
+            push(jump, node, entry.g + cost);
+        }
+    }
+    return false;
+}
+
+template <typename Passable>
+int JumpPointSearch::jumpHorizontal(int x, int y, int dx, Passable &passable) const
+{
+    for (;;) {
+        x += dx;
+        if (!open(x, y, passable)) return -1;
+        const int node = y * m_width + x;
+        if (node == m_goal) return node;
+        if (open(x, y - 1, passable) && !open(x - dx, y - 1, passable)) return node;
+        if (open(x, y + 1, passable) && !open(x - dx, y + 1, passable)) return node;
+    }
+}
+
+template <typename Passable>
+int JumpPointSearch::jumpVertical(int x, int y, int dy, Passable &passable) const
+{
+    for (;;) {
+        y += dy;
+        if (!open(x, y, passable)) return -1;
+        const int node = y * m_width + x;
+        if (node == m_goal) return node;
+        // 两侧横扫碰到跳点时，这一格就是拐弯的地方
+        if (jumpHorizontal(x, y, 1, passable) >= 0 || jumpHorizontal(x, y, -1, passable) >= 0) return node;
+    }
+}
+
+#endif // JUMPPOINTSEARCH_H
@@ -0,0 +1,163 @@
+#include "maptopology.h"
+#include "tilemap.h"
+
+namespace {
+const int DX[4] = { 1, -1, 0, 0 };
+const int DY[4] = { 0, 0, 1, -1 };
+}
+
+void MapTopology::rebuild(const TileMap &tiles)
+{
+    m_columns = tiles.columns();
+    m_rows = tiles.rows();
+    const int cells = m_columns * m_rows;
+    m_open.fill(0, cells);
+    m_degree.fill(0, cells);
+    for (int row = 0; row < m_rows; ++row) {
+        for (int col = 0; col < m_columns; ++col) {
+            m_open[index(col, row)] = tiles.tileAt(col, row) == TileMap::EMPTY;
+        }
+    }
+    for (int i = 0; i < cells; ++i) {
+        if (!m_open[i]) continue;
+        for (int dir = 0; dir < 4; ++dir) {
+            if (neighbor(i, dir) >= 0) ++m_degree[i];
+        }
+    }
+    m_dirty = true;
+}
+
+void MapTopology::openCell(int col, int row)
+{
+    if (!contains(col, row) || isOpen(col, row)) return;
+    const int i = index(col, row);
+    m_open[i] = 1;
+    for (int dir = 0; dir < 4; ++dir) {
+        const int n = neighbor(i, dir);
+        if (n < 0) continue;
+        ++m_degree[i];
+        ++m_degree[n];
+    }
+    m_dirty = true;
+}
+
+MapTopology::Kind MapTopology::kindAt(int col, int row) const
+{
+    if (!isOpen(col, row)) return CLOSED;
+    const int degree = m_degree[index(col, row)];
+    if (degree <= 1) return DEAD_END;
+    return degree == 2 ? CORRIDOR : JUNCTION;
+}
+
+bool MapTopology::isArticulation(int col, int row) const
+{
+    if (!isOpen(col, row)) return false;
+    if (m_dirty) analyze();
+    return m_cut[index(col, row)];
+}
+
+int MapTopology::sideSize(const QPoint &cut, const QPoint &cell) const
+{
+    if (!isOpen(cell.x(), cell.y()) || cut == cell) return 0;
+    if (m_dirty) analyze();
+    const int w = index(cell.x(), cell.y());
+    const int region = m_size[m_root[w]];
+    if (!isOpen(cut.x(), cut.y())) return region;
+    const int c = index(cut.x(), cut.y());
+    if (m_root[c] != m_root[w]) return region;
+    if (!m_cut[c]) return region - 1;
+
+    // 和 cut 断开的是那些 low 够不到 cut 之上的子树，cell 在其中一棵里就是这棵的大小，否则是剩下的部分
+    int separated = 0;
+    for (int dir = 0; dir < 4; ++dir) {
+        const int u = neighbor(c, dir);
+        if (u < 0 || m_parent[u] != c || m_low[u] < m_disc[c]) continue;
+        if (m_disc[w] >= m_disc[u] && m_disc[w] < m_disc[u] + m_size[u]) return m_size[u];
+        separated += m_size[u];
+    }
+    return region - 1 - separated;
+}
+
+int MapTopology::pocketSize(int col, int row) const
+{
+    if (!isOpen(col, row)) return 0;
+    if (m_dirty) analyze();
+    return m_pocket[index(col, row)];
+}
+
+int MapTopology::neighbor(int i, int dir) const
+{
+    const int col = i % m_columns + DX[dir];
+    const int row = i / m_columns + DY[dir];
+    return isOpen(col, row) ? index(col, row) : -1;
+}
+
+void MapTopology::analyze() const
+{
+    const int cells = m_columns * m_rows;
+    m_disc.fill(-1, cells);
+    m_low.fill(0, cells);
+    m_parent.fill(-1, cells);
+    m_size.fill(0, cells);
+    m_root.fill(-1, cells);
+    m_cut.fill(0, cells);
+    m_pocket.fill(0, cells);
+    m_next.fill(0, cells);
+    m_order.resize(0);
+    m_stack.resize(0);
+
+    // 根从度数大的方格里挑：路口很少落在死胡同里，口袋就都在子树这一侧
+    int clock = 0;
+    for (int degree = 4; degree >= 0; --degree) {
+        for (int i = 0; i < cells; ++i) {
+            if (m_open[i] && m_degree[i] == degree && m_disc[i] < 0) {
+                search(i, clock);
+            }
+        }
+    }
+
+    // 按先序处理，父节点总在子节点之前：离得最近的那个割点给出最小的口袋
+    for (int i : m_order) {
+        const int p = m_parent[i];
+        if (p < 0) continue;
+        m_pocket[i] = (m_cut[p] && m_low[i] >= m_disc[p]) ? m_size[i] : m_pocket[p];
+    }
+    m_dirty = false;
+}
+
+void MapTopology::search(int root, int &clock) const
+{
+    // 非递归 DFS，m_next 记着每格看到第几个方向
+    int rootChildren = 0;
+    m_disc[root] = m_low[root] = clock++;
+    m_root[root] = root;
+    m_order.append(root);
+    m_stack.append(root);
+    while (!m_stack.isEmpty()) {
+        const int cur = m_stack.last();
+        if (m_next[cur] < 4) {
+            const int n = neighbor(cur, m_next[cur]++);
+            if (n < 0) continue;
+            if (m_disc[n] < 0) {
+                m_parent[n] = cur;
+                m_root[n] = root;
+                m_disc[n] = m_low[n] = clock++;
+                m_order.append(n);
+                m_stack.append(n);
+                if (cur == root) ++rootChildren;
+            } else if (n != m_parent[cur]) {
+                m_low[cur] = qMin(m_low[cur], m_disc[n]);
+            }
+            continue;
+        }
+
+        // 子树全部编号完毕：编号连续，大小就是差值
+        m_stack.removeLast();
+        m_size[cur] = clock - m_disc[cur];
+        const int p = m_parent[cur];
+        if (p < 0) continue;
+        m_low[p] = qMin(m_low[p], m_low[cur]);
+        if (p != root && m_low[cur] >= m_disc[p]) m_cut[p] = 1;
+    }
+    m_cut[root] = rootChildren >= 2;
+}
@@ -0,0 +1,63 @@
+#ifndef MAPTOPOLOGY_H
+#define MAPTOPOLOGY_H
+
+#include <QPoint>
+#include <QVector>
+#include <QtGlobal>
+
+class TileMap;
+
+// 空地方格图的拓扑：每格按空邻居数分成死胡同、走廊、路口，砖块被炸掉时只改它和四个邻居
+// 割点和“口袋”（堵住一个割点后被关在里面的那一侧）要整图做一次 Tarjan DFS，
+// 砖块消失后先记脏，第一次查询时再算；之后困住目标、把自己逼进死角之类的判断都是查表
+// 只看地形，炸弹这种暂时的障碍不算在内
+class MapTopology
+{
+public:
+    enum Kind { CLOSED, DEAD_END, CORRIDOR, JUNCTION };
+
+    void rebuild(const TileMap &tiles);
+    void openCell(int col, int row);  // 砖块被炸掉
+
+    bool isOpen(int col, int row) const {
+        return contains(col, row) && m_open[index(col, row)];
+    }
+    Kind kindAt(int col, int row) const;
+
+    bool isArticulation(int col, int row) const;
+    // 堵住 cut 之后从 cell 还能走到的空地数（不含 cut）；cell 就是 cut 或者不是空地时为 0
+    // cut 最多四个 DFS 子节点，逐个比较子树区间，O(1)
+    int sideSize(const QPoint &cut, const QPoint &cell) const;
+    // cell 所在的口袋：往外最近的一个割点堵住后被关在里面的格数，没有这样的割点时为 0
+    // 每个连通区域的 DFS 从度数最大的方格开始，根落在口袋里的少见情况会漏报，不会误报
+    int pocketSize(int col, int row) const;
+
+private:
+    int m_columns = 0;
+    int m_rows = 0;
+    QVector<quint8> m_open;
+    QVector<quint8> m_degree;
+
+    // Tarjan DFS 的结果，m_dirty 时下次查询前重算
+    mutable bool m_dirty = true;
+    mutable QVector<qint32> m_disc;      // 先序编号，同一子树的编号连续
+    mutable QVector<qint32> m_low;
+    mutable QVector<qint32> m_parent;    // DFS 树上的父节点，根为 -1
+    mutable QVector<qint32> m_size;      // 子树大小
+    mutable QVector<qint32> m_root;      // 所在连通区域的 DFS 根
+    mutable QVector<quint8> m_cut;
+    mutable QVector<qint32> m_pocket;    // 口袋格数
+    mutable QVector<qint32> m_order;     // 按先序编号排好的方格
+    mutable QVector<qint32> m_stack;     // DFS 栈：方格下标
+    mutable QVector<quint8> m_next;      // 每格下一个要看的方向
+
+    bool contains(int col, int row) const {
+        return col >= 0 && row >= 0 && col < m_columns && row < m_rows;
+    }
+    int index(int col, int row) const { return row * m_columns + col; }
+    int neighbor(int i, int dir) const;  // 不是空地时为 -1
+    void analyze() const;
+    void search(int root, int &clock) const;
+};
+
+#endif // MAPTOPOLOGY_H
@@ -1,120 +1,128 @@
 #include "player.h"
-#include <QBrush>
-#include <QPen>
-#include <QAbstractAnimation>
-
-Player::Player(int x, int y, QGraphicsItem *parent)
-    : QObject()
-    , QGraphicsEllipseItem(0, 0, Player::SIZE_PIXELS, Player::SIZE_PIXELS, parent)
-    , m_moveAnim(new QVariantAnimation(this))
+
+namespace {
+// 身体压得最多的那一格：左上角加半个身位所在的方格
+QPoint centerCellOf(const QPoint &pos)
+{
+    return QPoint((pos.x() + Player::SIZE_UNITS / 2) / GameConstants::BLOCK_SIZE,
+                  (pos.y() + Player::SIZE_UNITS / 2) / GameConstants::BLOCK_SIZE);
+}
+}
+
+Player::Player(int x, int y, bool isBot, QObject *parent)
+    : QObject(parent)
     , m_canMove(true)
-    , m_targetPos(QPointF(x * GameConstants::UNIT_SIZE, y * GameConstants::UNIT_SIZE))
+    , m_isBot(isBot)
+    , m_bombRange(GameConstants::BOMB_RANGE)
+    , m_stepTick(0)
+    , m_origin(x, y)
 {
-    // 设置玩家外观
-    setBrush(QBrush(Qt::blue));
-    setPen(QPen(Qt::darkBlue, 1));
-    setZValue(5); // 确保玩家在炸弹之上
-    
-    // 设置初始位置（x, y是逻辑单位，转换为像素）
-    setPos(m_targetPos);
-    
-    // 设置插值动画，75ms完成一次移动
-    m_moveAnim->setDuration(75);
-    m_moveAnim->setEasingCurve(QEasingCurve::Linear);
-    connect(m_moveAnim, &QVariantAnimation::valueChanged, this, [this](const QVariant &value) {
-        setPos(value.toPointF());
-    });
-    connect(m_moveAnim, &QVariantAnimation::finished, this, [this]() {
-        // 保持目标位置，避免回弹
-        setPos(m_targetPos);
-        m_canMove = true;
-    });
 }
 
 void Player::moveUp()
 {
-    if (!m_canMove) return;
-    
-    // 每次移动1/4格（1个逻辑单位 = 8px），细腻操作
-    m_canMove = false;
-    QPointF start = pos();
-    const qreal stepPx = GameConstants::UNIT_SIZE;  // 1个单位 = 8像素
-    QPointF end = start + QPointF(0, -stepPx);
-    m_targetPos = end;
-    m_moveAnim->stop();
-    m_moveAnim->setStartValue(start);
-    m_moveAnim->setEndValue(end);
-    m_moveAnim->start();
+    // 每次移动1/4格（1个逻辑单位），细腻操作
+    startStep(0, -1);
 }
 
 void Player::moveDown()
 {
-    if (!m_canMove) return;
-    
-    m_canMove = false;
-    QPointF start = pos();
-    const qreal stepPx = GameConstants::UNIT_SIZE;  // 1个单位 = 8像素
-    QPointF end = start + QPointF(0, stepPx);
-    m_targetPos = end;
-    m_moveAnim->stop();
-    m_moveAnim->setStartValue(start);
-    m_moveAnim->setEndValue(end);
-    m_moveAnim->start();
+    startStep(0, 1);
 }
 
 void Player::moveLeft()
 {
-    if (!m_canMove) return;
-    
-    m_canMove = false;
-    QPointF start = pos();
-    const qreal stepPx = GameConstants::UNIT_SIZE;  // 1个单位 = 8像素
-    QPointF end = start + QPointF(-stepPx, 0);
-    m_targetPos = end;
-    m_moveAnim->stop();
-    m_moveAnim->setStartValue(start);
-    m_moveAnim->setEndValue(end);
-    m_moveAnim->start();
+    startStep(-1, 0);
 }
 
 void Player::moveRight()
+{
+    startStep(1, 0);
+}
+
+void Player::startStep(int dx, int dy)
 {
     if (!m_canMove) return;
     
+    // 一步分 MOVE_STEP_TICKS 个子步完成（75ms）
+    snapToGrid();
     m_canMove = false;
-    QPointF start = pos();
-    const qreal stepPx = GameConstants::UNIT_SIZE;  // 1个单位 = 8像素
-    QPointF end = start + QPointF(stepPx, 0);
-    m_targetPos = end;
-    m_moveAnim->stop();
-    m_moveAnim->setStartValue(start);
-    m_moveAnim->setEndValue(end);
-    m_moveAnim->start();
+    m_step = QPoint(dx, dy);
+    m_stepTick = 0;
+}
+
+void Player::advance()
+{
+    if (m_canMove || !isMoving()) return;
+    
+    if (++m_stepTick >= GameConstants::MOVE_STEP_TICKS) {
+        // 到达目标单位
+        const QPoint cell = centerCell();
+        m_origin += m_step;
+        m_step = QPoint();
+        m_stepTick = 0;
+        m_canMove = true;
+        emit positionChanged();
+        notifyCell(cell);
+        return;
+    }
+    emit positionChanged();
 }
 
-QPointF Player::getPosition() const
+QPoint Player::getPosition() const
 {
-    return pos();
+    // 走过半步以上就算到了下一个单位
+    if (m_stepTick * 2 > GameConstants::SUBSTEPS_PER_UNIT) {
+        return m_origin + m_step;
+    }
+    return m_origin;
 }
 
 void Player::setPosition(int x, int y)
 {
-    // x, y是逻辑单位，转换为像素
-    m_targetPos = QPointF(x * GameConstants::UNIT_SIZE, y * GameConstants::UNIT_SIZE);
-    setPos(m_targetPos);
+    const QPoint cell = centerCell();
+    m_origin = QPoint(x, y);
+    m_step = QPoint();
+    m_stepTick = 0;
+    emit positionChanged();
+    notifyCell(cell);
+}
+
+bool Player::overlaps(int x, int y, int size) const
+{
+    const int s = GameConstants::SUBSTEPS_PER_UNIT;
+    const QPoint p = fixedPos();
+    return p.x() < (x + size) * s && x * s < p.x() + SIZE_UNITS * s
+        && p.y() < (y + size) * s && y * s < p.y() + SIZE_UNITS * s;
+}
+
+QRect Player::coveredCells() const
+{
+    const int cellSize = GameConstants::BLOCK_SIZE * GameConstants::SUBSTEPS_PER_UNIT;
+    const int bodySize = SIZE_UNITS * GameConstants::SUBSTEPS_PER_UNIT;
+    const QPoint p = fixedPos();
+    return QRect(QPoint(p.x() / cellSize, p.y() / cellSize),
+                 QPoint((p.x() + bodySize - 1) / cellSize, (p.y() + bodySize - 1) / cellSize));
+}
+
+QPoint Player::centerCell() const
+{
+    return centerCellOf(m_origin);
+}
+
+int Player::stepTicksLeft() const
+{
+    return isMoving() ? GameConstants::MOVE_STEP_TICKS - m_stepTick : 0;
 }
 
 bool Player::isMoving() const
 {
-    return m_moveAnim->state() == QAbstractAnimation::Running;
+    return !m_step.isNull();
 }
 
 void Player::interruptMove()
 {
-    if (m_moveAnim->state() == QAbstractAnimation::Running) {
-        m_moveAnim->stop();
-    }
-    // 中断后对齐到1/4格网格，避免位置残留小数导致重叠
+    // 中断后对齐到1/4格网格，避免位置残留子步导致重叠
     snapToGrid();
     m_canMove = true;
 }
@@ -136,11 +144,18 @@ void Player::setCanMove(bool canMove)
 
 void Player::snapToGrid()
 {
-    QPointF p = pos();
-    // 对齐到1/4格网格（1个单位 = 8像素）
-    const qreal unitPx = GameConstants::UNIT_SIZE;
-    qreal gx = std::round(p.x() / unitPx) * unitPx;
-    qreal gy = std::round(p.y() / unitPx) * unitPx;
-    m_targetPos = QPointF(gx, gy);
-    setPos(m_targetPos);
+    if (!isMoving()) return;
+    const QPoint cell = centerCell();
+    const QPoint snapped = getPosition();
+    m_origin = snapped;
+    m_step = QPoint();
+    m_stepTick = 0;
+    emit positionChanged();
+    notifyCell(cell);
+}
+
+void Player::notifyCell(const QPoint &from)
+{
+    const QPoint to = centerCell();
+    if (to != from) emit cellChanged(from, to);
 }
@@ -1,32 +1,46 @@
 #ifndef PLAYER_H
 #define PLAYER_H
 
-#include <QGraphicsEllipseItem>
 #include <QObject>
-#include <QKeyEvent>
-#include <QVariantAnimation>
-#include <QTimer>
+#include <QPoint>
+#include <QRect>
 #include "gameconstants.h"
+#include "slotmap.h"
 
-class Player : public QObject, public QGraphicsEllipseItem
+// 玩家/机器人的逻辑实体，只保存位置和移动状态，不依赖图形界面
+// 位置是整数逻辑单位加上当前这一步的定点子步，像素只在渲染层换算
+class Player : public QObject
 {
     Q_OBJECT
 
 public:
-    Player(int x, int y, QGraphicsItem *parent = nullptr);
+    Player(int x, int y, bool isBot = false, QObject *parent = nullptr);
     
     void moveUp();
     void moveDown();
     void moveLeft();
     void moveRight();
+    void advance();  // 推进一个 tick，走完 MOVE_STEP_TICKS 个子步即到达下一个单位
     
-    QPointF getPosition() const;
+    QPoint getPosition() const;  // 最接近的逻辑单位，移动中按子步四舍五入
+    QPoint stepTarget() const { return m_origin + m_step; }  // 当前这一步走完后的位置，没在移动时就是当前位置
+    int stepTicksLeft() const;   // 当前这一步还要几个 tick 走完，没在移动时为 0
     void setPosition(int x, int y);  // 参数是逻辑单位
+    // 定点位置，单位是 1/SUBSTEPS_PER_UNIT 个逻辑单位
+    QPoint fixedPos() const { return m_origin * GameConstants::SUBSTEPS_PER_UNIT + m_step * m_stepTick; }
+    // 身体与左上角 (x, y)、边长 size 的方块是否重叠（逻辑单位，只接触边缘不算）
+    bool overlaps(int x, int y, int size) const;
+    QRect coveredCells() const;  // 身体压到的方格范围（最多 2x2）
+    QPoint centerCell() const;   // 停在当前这一步起点时身体压得最多的那一格（方格坐标）
+    bool isBot() const { return m_isBot; }
+    int bombRange() const { return m_bombRange; }  // 放下的炸弹火焰每个方向走几格
+    EntityHandle handle() const { return m_handle; }  // 机器人在 GameBotManager 中的句柄
+    void setHandle(EntityHandle handle) { m_handle = handle; }
     
     bool canMove() const;
     void setCanMove(bool canMove);
     bool isMoving() const;
-    void interruptMove();  // 中断当前移动动画，立即可拐弯
+    void interruptMove();  // 中断当前这一步，立即可拐弯
     void alignToGrid();    // 对齐到网格中心，消除残留偏差
     
     // 玩家大小为4个单位x4个单位，显示时转换为像素
@@ -35,11 +49,21 @@ public:
         SIZE_PIXELS = SIZE_UNITS * GameConstants::UNIT_SIZE  // 32像素
     };
 
+signals:
+    void positionChanged();
+    void cellChanged(const QPoint &from, const QPoint &to);  // centerCell() 变了
+
 private:
-    QVariantAnimation *m_moveAnim;
     bool m_canMove;
-    QPointF m_targetPos;
+    bool m_isBot;
+    int m_bombRange;
+    int m_stepTick;   // 当前一步已经走过的子步数
+    QPoint m_origin;  // 当前一步的起点（逻辑单位）
+    QPoint m_step;    // 当前一步的方向，不在移动时为 (0, 0)
+    EntityHandle m_handle;
+    void startStep(int dx, int dy);
     void snapToGrid();
+    void notifyCell(const QPoint &from);
 };
 
 #endif // PLAYER_H
@@ -0,0 +1,27 @@
+#include "playeritem.h"
+#include "player.h"
+#include <QBrush>
+#include <QPen>
+
+PlayerItem::PlayerItem(const Player *player, QGraphicsItem *parent)
+    : QGraphicsEllipseItem(0, 0, Player::SIZE_PIXELS, Player::SIZE_PIXELS, parent)
+{
+    if (player->isBot()) {
+        // 机器人 - 深绿色
+        setBrush(QBrush(Qt::darkGreen));
+        setPen(QPen(Qt::black, 1));
+    } else {
+        // 玩家 - 蓝色
+        setBrush(QBrush(Qt::blue));
+        setPen(QPen(Qt::darkBlue, 1));
+    }
+    setZValue(5); // 确保玩家在炸弹之上
+    syncPosition(player);
+}
+
+void PlayerItem::syncPosition(const Player *player)
+{
+    const QPoint p = player->fixedPos();
+    const qreal scale = qreal(GameConstants::UNIT_SIZE) / GameConstants::SUBSTEPS_PER_UNIT;
+    setPos(p.x() * scale, p.y() * scale);
+}
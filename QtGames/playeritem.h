@@ -0,0 +1,17 @@
+#ifndef PLAYERITEM_H
+#define PLAYERITEM_H
+
+#include <QGraphicsEllipseItem>
+
+class Player;
+
+// 玩家/机器人的显示图元，位置跟随逻辑实体
+class PlayerItem : public QGraphicsEllipseItem
+{
+public:
+    explicit PlayerItem(const Player *player, QGraphicsItem *parent = nullptr);
+    
+    void syncPosition(const Player *player);  // 定点逻辑坐标换算成像素
+};
+
+#endif // PLAYERITEM_H
@@ -0,0 +1,78 @@
+#include "reservationtable.h"
+
+void ReservationTable::reset(int columns, int rows)
+{
+    m_columns = columns;
+    m_rows = rows;
+    m_bodies.fill(0, columns * rows);
+    m_claims.fill(Claim(), columns * rows * CLAIMS_PER_CELL);
+    m_owned.clear();
+}
+
+void ReservationTable::addBody(const QPoint &cell)
+{
+    if (!contains(cell.x(), cell.y())) return;
+    quint8 &count = m_bodies[index(cell.x(), cell.y())];
+    if (count < 0xFF) ++count;
+}
+
+void ReservationTable::removeBody(const QPoint &cell)
+{
+    if (!contains(cell.x(), cell.y())) return;
+    quint8 &count = m_bodies[index(cell.x(), cell.y())];
+    if (count > 0) --count;
+}
+
+void ReservationTable::claim(int owner, int col, int row, quint64 from, quint64 to)
+{
+    if (owner < 0 || !contains(col, row) || from >= to) return;
+    const int cell = index(col, row);
+    Claim *claims = m_claims.data() + cell * CLAIMS_PER_CELL;
+
+    // 同一个 owner 在这格已经有预约就合并；否则用空位，没有空位挤掉最早结束的
+    int slot = -1;
+    for (int i = 0; i < CLAIMS_PER_CELL; ++i) {
+        if (claims[i].owner == owner) {
+            claims[i].from = qMin(claims[i].from, from);
+            claims[i].to = qMax(claims[i].to, to);
+            return;
+        }
+        if (slot < 0 || (claims[slot].owner >= 0 && (claims[i].owner < 0 || claims[i].to < claims[slot].to))) {
+            slot = i;
+        }
+    }
+    claims[slot].owner = owner;
+    claims[slot].from = from;
+    claims[slot].to = to;
+
+    if (m_owned.size() <= owner) {
+        m_owned.resize(owner + 1);
+    }
+    m_owned[owner].append(cell);
+}
+
+void ReservationTable::release(int owner)
+{
+    if (owner < 0 || owner >= m_owned.size()) return;
+    for (int cell : m_owned[owner]) {
+        Claim *claims = m_claims.data() + cell * CLAIMS_PER_CELL;
+        for (int i = 0; i < CLAIMS_PER_CELL; ++i) {
+            if (claims[i].owner == owner) claims[i] = Claim();
+        }
+    }
+    m_owned[owner].resize(0);
+}
+
+int ReservationTable::cost(int owner, const QPoint &selfCell, int col, int row, quint64 from, quint64 to) const
+{
+    if (!contains(col, row)) return 0;
+    const int cell = index(col, row);
+    int total = m_bodies[cell];
+    if (selfCell == QPoint(col, row) && total > 0) --total;
+    const Claim *claims = m_claims.constData() + cell * CLAIMS_PER_CELL;
+    for (int i = 0; i < CLAIMS_PER_CELL; ++i) {
+        if (claims[i].owner < 0 || claims[i].owner == owner) continue;
+        if (claims[i].from < to && from < claims[i].to) ++total;
+    }
+    return total;
+}
@@ -0,0 +1,53 @@
+#ifndef RESERVATIONTABLE_H
+#define RESERVATIONTABLE_H
+
+#include <QPoint>
+#include <QVector>
+#include <QtGlobal>
+
+// 多个机器人协同寻路用的占用层和时空预约表（方格坐标，定时器时间）
+// 占用层记录每格站着几个身体，由玩家换格的事件增量维护，不用每次去问每个实体的位置
+// 预约表记录“谁打算在哪段时间经过哪一格”，别的机器人规划时把它们当作软代价，
+// 等长的路线里挑不挤的那条，自然就分散开了
+class ReservationTable
+{
+public:
+    enum : int { CLAIMS_PER_CELL = 4 };  // 每格最多同时记几条预约，满了挤掉最早结束的
+
+    void reset(int columns, int rows);
+
+    // 身体占用
+    void addBody(const QPoint &cell);
+    void removeBody(const QPoint &cell);
+    int bodiesAt(int col, int row) const {
+        return contains(col, row) ? m_bodies[index(col, row)] : 0;
+    }
+
+    // owner 打算在 [from, to) 期间经过 (col, row)；owner 是非负整数（机器人句柄的槽位）
+    void claim(int owner, int col, int row, quint64 from, quint64 to);
+    void release(int owner);  // 撤销 owner 的所有预约
+
+    // 在 [from, to) 期间进入 (col, row) 的软代价：别人的身体和时间上重叠的别人的预约
+    // selfCell 是 owner 自己身体所在的格，那里的身体不算
+    int cost(int owner, const QPoint &selfCell, int col, int row, quint64 from, quint64 to) const;
+
+private:
+    struct Claim {
+        qint32 owner = -1;
+        quint64 from = 0;
+        quint64 to = 0;
+    };
+
+    int m_columns = 0;
+    int m_rows = 0;
+    QVector<quint8> m_bodies;
+    QVector<Claim> m_claims;             // 每格 CLAIMS_PER_CELL 条
+    QVector<QVector<qint32>> m_owned;    // 每个 owner 预约过的方格下标，撤销时只看这些
+
+    bool contains(int col, int row) const {
+        return col >= 0 && row >= 0 && col < m_columns && row < m_rows;
+    }
+    int index(int col, int row) const { return row * m_columns + col; }
+};
+
+#endif // RESERVATIONTABLE_H
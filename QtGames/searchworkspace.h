@@ -0,0 +1,67 @@
+#ifndef SEARCHWORKSPACE_H
+#define SEARCHWORKSPACE_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// 可复用的 BFS 工作区：节点用整数下标表示（网格位置、时空状态都行），
+// 访问标记用“轮次”代替清空，父节点、深度和队列都是扁平数组
+// 节点数不超过已分配的容量时，每次搜索不做任何堆分配
+class SearchWorkspace
+{
+public:
+    // 开始一次新的搜索，节点数超过容量时才重新分配
+    void begin(int nodes) {
+        if (nodes > m_stamp.size()) {
+            m_stamp.fill(0, nodes);
+            m_parent.resize(nodes);
+            m_depth.resize(nodes);
+            m_queue.resize(nodes);
+            m_epoch = 0;
+        }
+        if (++m_epoch == 0) {
+            // 轮次回绕后旧标记可能与新轮次冲突，只有这时才真正清空
+            m_stamp.fill(0);
+            m_epoch = 1;
+        }
+        m_head = 0;
+        m_tail = 0;
+    }
+
+    bool isVisited(int node) const { return m_stamp[node] == m_epoch; }
+    // 标记访问并入队，parent 等于 node 表示源点（深度 0）；已访问过返回 false
+    bool visit(int node, int parent) {
+        if (m_stamp[node] == m_epoch) return false;
+        m_stamp[node] = m_epoch;
+        m_parent[node] = parent;
+        m_depth[node] = parent == node ? 0 : m_depth[parent] + 1;
+        m_queue[m_tail++] = node;
+        return true;
+    }
+    // 以下两个只对本次已访问的节点有意义
+    int parentOf(int node) const { return m_parent[node]; }
+    int depthOf(int node) const { return m_depth[node]; }
+
+    // 每个节点最多入队一次，队列不需要回绕
+    bool isEmpty() const { return m_head == m_tail; }
+    int pop() { return m_queue[m_head++]; }
+
+    // 从 node 回溯，返回紧跟在源点后面的那个节点；node 本身是源点时返回 node
+    int firstAfterSource(int node) const {
+        while (m_parent[node] != node && m_parent[m_parent[node]] != m_parent[node]) {
+            node = m_parent[node];
+        }
+        return node;
+    }
+
+private:
+    quint32 m_epoch = 0;
+    QVector<quint32> m_stamp;  // 等于当前轮次表示本次已访问
+    QVector<qint32> m_parent;
+    QVector<qint32> m_depth;   // 到最近源点的步数
+    QVector<qint32> m_queue;
+    int m_head = 0;
+    int m_tail = 0;
+};
+
+#endif // SEARCHWORKSPACE_H
@@ -0,0 +1,113 @@
+#ifndef SLOTMAP_H
+#define SLOTMAP_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// 实体句柄：槽位下标 + 代数，实体被移除后代数加一，旧句柄随之失效
+struct EntityHandle
+{
+    qint32 index = -1;
+    quint32 generation = 0;
+
+    bool isValid() const { return index >= 0; }
+    // 打包成一个整数，方便放进定时器等只接受整数负载的地方
+    quint64 pack() const { return (quint64(generation) << 32) | quint32(index); }
+    static EntityHandle unpack(quint64 packed) {
+        EntityHandle h;
+        h.index = qint32(quint32(packed));
+        h.generation = quint32(packed >> 32);
+        return h;
+    }
+    bool operator==(const EntityHandle &other) const {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const EntityHandle &other) const { return !(*this == other); }
+};
+
+// 槽位表：插入、删除、校验句柄都是 O(1)，值连续存放便于每 tick 遍历
+// 删除时把最后一个值挪到空位，所以遍历顺序在删除后会变化
+template <typename T>
+class SlotMap
+{
+public:
+    EntityHandle insert(const T &value) {
+        qint32 slot = m_freeHead;
+        if (slot >= 0) {
+            m_freeHead = m_slots[slot].nextFree;
+        } else {
+            slot = m_slots.size();
+            m_slots.append(Slot());
+        }
+        m_slots[slot].dense = m_values.size();
+        m_values.append(value);
+        m_denseToSlot.append(slot);
+
+        EntityHandle h;
+        h.index = slot;
+        h.generation = m_slots[slot].generation;
+        return h;
+    }
+
+    bool remove(EntityHandle h) {
+        if (!contains(h)) return false;
+        Slot &slot = m_slots[h.index];
+        const int dense = slot.dense;
+        const int last = m_values.size() - 1;
+        if (dense != last) {
+            m_values[dense] = m_values[last];
+            m_denseToSlot[dense] = m_denseToSlot[last];
+            m_slots[m_denseToSlot[dense]].dense = dense;
+        }
+        m_values.removeLast();
+        m_denseToSlot.removeLast();
+
+        slot.dense = -1;
+        ++slot.generation;
+        slot.nextFree = m_freeHead;
+        m_freeHead = h.index;
+        return true;
+    }
+
+    bool contains(EntityHandle h) const {
+        return h.index >= 0 && h.index < m_slots.size()
+               && m_slots[h.index].generation == h.generation
+               && m_slots[h.index].dense >= 0;
+    }
+
+    // 句柄失效时返回 defaultValue（存指针时就是 nullptr）
+    T value(EntityHandle h, const T &defaultValue = T()) const {
+        return contains(h) ? m_values[m_slots[h.index].dense] : defaultValue;
+    }
+
+    const QVector<T>& values() const { return m_values; }
+    int size() const { return m_values.size(); }
+    bool isEmpty() const { return m_values.isEmpty(); }
+
+    void clear() {
+        // 所有槽位的代数都加一，旧句柄全部失效
+        for (int i = 0; i < m_denseToSlot.size(); ++i) {
+            Slot &slot = m_slots[m_denseToSlot[i]];
+            slot.dense = -1;
+            ++slot.generation;
+            slot.nextFree = m_freeHead;
+            m_freeHead = m_denseToSlot[i];
+        }
+        m_values.clear();
+        m_denseToSlot.clear();
+    }
+
+private:
+    struct Slot {
+        quint32 generation = 0;
+        qint32 dense = -1;     // 值在 m_values 中的下标，-1 表示空闲
+        qint32 nextFree = -1;
+    };
+
+    QVector<Slot> m_slots;
+    QVector<T> m_values;
+    QVector<qint32> m_denseToSlot;
+    qint32 m_freeHead = -1;
+};
+
+#endif // SLOTMAP_H
@@ -0,0 +1,447 @@
+#include <QtTest>
+#include <QQueue>
+#include <cstring>
+#include "blastindex.h"
+#include "bomb.h"
+#include "cellrouter.h"
+#include "escapeplanner.h"
+#include "gameengine.h"
+#include "jumppointsearch.h"
+#include "maptopology.h"
+#include "reservationtable.h"
+#include "slotmap.h"
+#include "tilemap.h"
+#include "timerwheel.h"
+
+namespace {
+// 按字符画建地图：'#' 是墙，'+' 是砖块，其他是空地
+template <int N>
+TileMap tilesFrom(const char *const (&rows)[N])
+{
+    const int columns = int(std::strlen(rows[0]));
+    TileMap tiles(columns, N);
+    for (int row = 0; row < N; ++row) {
+        for (int col = 0; col < columns; ++col) {
+            const char c = rows[row][col];
+            tiles.setTile(col, row, c == '#' ? TileMap::WALL : (c == '+' ? TileMap::BRICK : TileMap::EMPTY));
+        }
+    }
+    return tiles;
+}
+
+// 固定种子的随机地图：四周是墙，里面大约 density% 的方格是墙
+TileMap randomTiles(quint32 seed, int columns, int rows, int density)
+{
+    QRandomGenerator rng(seed);
+    TileMap tiles(columns, rows);
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < columns; ++col) {
+            const bool border = col == 0 || row == 0 || col == columns - 1 || row == rows - 1;
+            const bool wall = border || int(rng.bounded(100)) < density;
+            tiles.setTile(col, row, wall ? TileMap::WALL : TileMap::EMPTY);
+        }
+    }
+    return tiles;
+}
+
+// 身体左上角放在逻辑单位 (x, y) 时压到的方格都是空地
+bool bodyFits(const TileMap &tiles, int x, int y)
+{
+    if (x < 0 || y < 0) return false;
+    const int size = GameConstants::BLOCK_SIZE;
+    for (int row = TileMap::cellOf(y); row <= TileMap::cellOf(y + size - 1); ++row) {
+        for (int col = TileMap::cellOf(x); col <= TileMap::cellOf(x + size - 1); ++col) {
+            if (tiles.tileAt(col, row) != TileMap::EMPTY) return false;
+        }
+    }
+    return true;
+}
+
+// 逐单位的多源 BFS，作为寻路结果的参照，-1 表示走不到
+template <typename Passable>
+QVector<int> bruteForceDistances(int width, int height, const QVector<QPoint> &sources, Passable passable)
+{
+    QVector<int> dist(width * height, -1);
+    QQueue<int> queue;
+    for (const QPoint &s : sources) {
+        const int i = s.y() * width + s.x();
+        if (dist[i] == 0) continue;
+        dist[i] = 0;
+        queue.enqueue(i);
+    }
+    const QPoint steps[4] = { QPoint(1, 0), QPoint(-1, 0), QPoint(0, 1), QPoint(0, -1) };
+    while (!queue.isEmpty()) {
+        const int cur = queue.dequeue();
+        for (const QPoint &d : steps) {
+            const int x = cur % width + d.x();
+            const int y = cur / width + d.y();
+            if (x < 0 || y < 0 || x >= width || y >= height || !passable(x, y)) continue;
+            const int next = y * width + x;
+            if (dist[next] >= 0) continue;
+            dist[next] = dist[cur] + 1;
+            queue.enqueue(next);
+        }
+    }
+    return dist;
+}
+}
+
+// 游戏核心（QtGamesCore）的单元测试：时间轮、槽位表、火焰索引、逃生规划、拓扑、寻路和连锁引爆
+class TestCore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void timerWheelFiresOnDeadline();
+    void slotMapRejectsStaleHandles();
+    void blastIndexStopsAtWallsAndBricks();
+    void escapePlannerLeavesFlamesInTime();
+    void escapePlannerReportsNoEscape();
+    void mapTopologyClassifiesCells();
+    void cellRouterMatchesBruteForce();
+    void jumpPointSearchMatchesBruteForce();
+    void reservationTableCountsOverlaps();
+    void sameTickFusesDetonateOnce();
+};
+
+void TestCore::timerWheelFiresOnDeadline()
+{
+    // 每一层的边界前后都放一个，最后一个超出三层进溢出桶
+    const int delays[] = { 1, 3, 63, 64, 65, 4095, 4096, 4097, 262143, 262145 };
+    const int count = int(sizeof(delays) / sizeof(delays[0]));
+    const int cancelled = 4;
+
+    TimerWheel wheel;
+    QVector<TimerWheel::TimerId> ids;
+    for (int i = 0; i < count; ++i) {
+        ids.append(wheel.schedule(delays[i], quint32(i), quint64(delays[i])));
+        QCOMPARE(wheel.remaining(ids[i]), delays[i]);
+    }
+    QVERIFY(wheel.cancel(ids[cancelled]));
+    QVERIFY(!wheel.isActive(ids[cancelled]));
+    QCOMPARE(wheel.size(), count - 1);
+
+    int fired = 0;
+    QVector<TimerWheel::Expired> expired;
+    while (wheel.size() > 0 && wheel.now() <= 262145) {
+        expired.clear();
+        wheel.advance(expired);
+        for (const TimerWheel::Expired &e : expired) {
+            QVERIFY(e.kind != quint32(cancelled));
+            QCOMPARE(wheel.now(), e.data);
+            QVERIFY(!wheel.isActive(ids[int(e.kind)]));
+            QCOMPARE(wheel.remaining(ids[int(e.kind)]), -1);
+            ++fired;
+        }
+    }
+    QCOMPARE(fired, count - 1);
+    QCOMPARE(wheel.size(), 0);
+}
+
+void TestCore::slotMapRejectsStaleHandles()
+{
+    SlotMap<int> map;
+    const EntityHandle a = map.insert(10);
+    const EntityHandle b = map.insert(20);
+    const EntityHandle c = map.insert(30);
+    QVERIFY(map.remove(b));
+    QVERIFY(!map.remove(b));
+    QVERIFY(!map.contains(b));
+    QCOMPARE(map.value(b, -1), -1);
+    QCOMPARE(map.size(), 2);
+    QCOMPARE(map.value(a), 10);
+    QCOMPARE(map.value(c), 30);
+
+    // 空出的槽位被复用，代数变了，旧句柄仍然无效
+    const EntityHandle d = map.insert(40);
+    QCOMPARE(d.index, b.index);
+    QVERIFY(d.generation != b.generation);
+    QVERIFY(!map.contains(b));
+    QCOMPARE(map.value(d), 40);
+    QCOMPARE(map.values().size(), 3);
+    QVERIFY(EntityHandle::unpack(d.pack()) == d);
+
+    map.clear();
+    QVERIFY(map.isEmpty());
+    QVERIFY(!map.contains(a));
+    QVERIFY(!map.contains(d));
+}
+
+void TestCore::blastIndexStopsAtWallsAndBricks()
+{
+    const char *const rows[] = {
+        "#######",
+        "#.....#",
+        "#.#.+.#",
+        "#.....#",
+        "#######",
+    };
+    TileMap tiles = tilesFrom(rows);
+    BlastIndex index;
+    index.rebuild(tiles);
+
+    // 射程没用完就停在空地上；够到墙时墙不算在火焰里
+    BlastIndex::Blast blast = index.blastAt(3, 1, 2);
+    QCOMPARE(blast.arms[BlastIndex::LEFT].length, 2);
+    QCOMPARE(int(blast.arms[BlastIndex::LEFT].stopper), int(TileMap::EMPTY));
+    QCOMPARE(blast.arms[BlastIndex::UP].length, 0);
+    QCOMPARE(int(blast.arms[BlastIndex::UP].stopper), int(TileMap::WALL));
+    QCOMPARE(blast.arms[BlastIndex::DOWN].length, 2);
+    blast = index.blastAt(3, 1, 3);
+    QCOMPARE(blast.arms[BlastIndex::RIGHT].length, 2);
+    QCOMPARE(int(blast.arms[BlastIndex::RIGHT].stopper), int(TileMap::WALL));
+
+    // 砖块被炸到但挡住后面的格子；砖块消失后火焰穿过去
+    blast = index.blastAt(4, 3, 2);
+    QCOMPARE(blast.arms[BlastIndex::UP].length, 1);
+    QCOMPARE(int(blast.arms[BlastIndex::UP].stopper), int(TileMap::BRICK));
+    QVERIFY(blast.reaches(4, 2));
+    QVERIFY(!blast.reaches(4, 1));
+    tiles.setTile(4, 2, TileMap::EMPTY);
+    index.clearObstacle(4, 2);
+    blast = index.blastAt(4, 3, 2);
+    QCOMPARE(blast.arms[BlastIndex::UP].length, 2);
+    QCOMPARE(int(blast.arms[BlastIndex::UP].stopper), int(TileMap::EMPTY));
+    QVERIFY(blast.reaches(4, 1));
+}
+
+void TestCore::escapePlannerLeavesFlamesInTime()
+{
+    // 5x5 格的空地，第 0 行在 now+30 起火、烧 16 个 tick；从左上角出发要往下走出这一行
+    const int size = GameConstants::BLOCK_SIZE;
+    const quint64 now = 100;
+    auto passable = [size](int x, int y) {
+        return x >= 0 && y >= 0 && x <= 4 * size && y <= 4 * size;
+    };
+    auto windowAt = [now](int col, int row) {
+        DangerTimeline::Window window;
+        if (row == 0 && col >= 0 && col <= 4) {
+            window.start = now + 30;
+            window.end = window.start + GameConstants::EXPLOSION_TICKS;
+        }
+        return window;
+    };
+    EscapePlanner planner;
+    EscapePlanner::Plan plan;
+    QVERIFY(planner.plan(QPoint(0, 0), now, passable, windowAt, [](int, int) { return 0; }, plan));
+
+    // 按移动节奏：每 MOVE_STEP_TICKS 一个逻辑单位，走一个身位正好离开第 0 行
+    QCOMPARE(plan.steps, size);
+    QCOMPARE(plan.departure, now);
+    QCOMPARE(plan.arrival, now + quint64(size * GameConstants::MOVE_STEP_TICKS));
+    QCOMPARE(plan.firstStep, QPoint(0, 1));
+    QPoint end(0, 0);
+    for (int k = 0; k < plan.steps; ++k) {
+        QVERIFY(qAbs(plan.moves[k].x()) + qAbs(plan.moves[k].y()) <= 1);
+        end += plan.moves[k];
+    }
+    QCOMPARE(end, QPoint(0, size));
+}
+
+void TestCore::escapePlannerReportsNoEscape()
+{
+    // 整片地方下一个 tick 就起火，怎么走都来不及
+    const int size = GameConstants::BLOCK_SIZE;
+    const quint64 now = 100;
+    auto passable = [size](int x, int y) {
+        return x >= 0 && y >= 0 && x <= 4 * size && y <= 4 * size;
+    };
+    auto windowAt = [now](int, int) {
+        DangerTimeline::Window window;
+        window.start = now + 1;
+        window.end = now + 1 + GameConstants::EXPLOSION_TICKS;
+        return window;
+    };
+    EscapePlanner planner;
+    EscapePlanner::Plan plan;
+    QVERIFY(!planner.plan(QPoint(2 * size, 2 * size), now, passable, windowAt, [](int, int) { return 0; }, plan));
+}
+
+void TestCore::mapTopologyClassifiesCells()
+{
+    // 一个环，下面挂着一条两格长的死胡同；(2, 4) 的砖块炸掉后死胡同的根部也连上环
+    const char *const rows[] = {
+        "#######",
+        "#.....#",
+        "#.###.#",
+        "#.....#",
+        "##+.###",
+        "###.###",
+        "#######",
+    };
+    TileMap tiles = tilesFrom(rows);
+    MapTopology topology;
+    topology.rebuild(tiles);
+
+    QCOMPARE(topology.kindAt(0, 0), MapTopology::CLOSED);
+    QCOMPARE(topology.kindAt(3, 5), MapTopology::DEAD_END);
+    QCOMPARE(topology.kindAt(3, 4), MapTopology::CORRIDOR);
+    QCOMPARE(topology.kindAt(3, 3), MapTopology::JUNCTION);
+    QVERIFY(topology.isArticulation(3, 3));
+    QVERIFY(topology.isArticulation(3, 4));
+    QVERIFY(!topology.isArticulation(1, 1));
+    QCOMPARE(topology.sideSize(QPoint(3, 3), QPoint(3, 5)), 2);
+    QCOMPARE(topology.sideSize(QPoint(3, 3), QPoint(1, 1)), 11);
+    QCOMPARE(topology.pocketSize(3, 5), 1);
+    QCOMPARE(topology.pocketSize(3, 4), 2);
+
+    tiles.setTile(2, 4, TileMap::EMPTY);
+    topology.openCell(2, 4);
+    QCOMPARE(topology.kindAt(3, 4), MapTopology::JUNCTION);
+    QVERIFY(!topology.isArticulation(3, 3));
+    QVERIFY(topology.isArticulation(3, 4));
+    QCOMPARE(topology.pocketSize(3, 5), 1);
+}
+
+void TestCore::cellRouterMatchesBruteForce()
+{
+    // 每个能站的逻辑单位位置都查一次：走得到时这一步必须落在最短路线上，走不到时要报告出来
+    const int size = GameConstants::BLOCK_SIZE;
+    for (quint32 seed = 1; seed <= 20; ++seed) {
+        const TileMap tiles = randomTiles(seed, 9, 9, 25);
+        const int width = tiles.columns() * size;
+        const int height = tiles.rows() * size;
+        auto walkable = [&tiles](int x, int y) { return bodyFits(tiles, x, y); };
+
+        QVector<QPoint> sources;
+        QVector<QPoint> unitSources;
+        QRandomGenerator rng(seed);
+        while (sources.size() < 2) {
+            const QPoint cell(int(rng.bounded(tiles.columns())), int(rng.bounded(tiles.rows())));
+            if (tiles.tileAt(cell.x(), cell.y()) != TileMap::EMPTY) continue;
+            sources.append(cell);
+            unitSources.append(cell * size);
+        }
+
+        CellRouter router;
+        router.compute(tiles.columns(), tiles.rows(), sources, [&tiles](int col, int row) {
+            return tiles.tileAt(col, row) == TileMap::EMPTY;
+        });
+        const QVector<int> dist = bruteForceDistances(width, height, unitSources, walkable);
+
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                if (!walkable(x, y)) continue;
+                const int d = dist[y * width + x];
+                QPoint step;
+                const bool found = router.nextStep(QPoint(x, y), walkable, step);
+                QCOMPARE(found, d >= 0);
+                if (!found) continue;
+                if (d == 0) {
+                    QCOMPARE(step, QPoint(0, 0));
+                    continue;
+                }
+                const QPoint next(x + step.x(), y + step.y());
+                QCOMPARE(qAbs(step.x()) + qAbs(step.y()), 1);
+                QVERIFY(walkable(next.x(), next.y()));
+                QCOMPARE(dist[next.y() * width + next.x()], d - 1);
+            }
+        }
+    }
+}
+
+void TestCore::jumpPointSearchMatchesBruteForce()
+{
+    // 随机起点终点：能不能到和逐格 BFS 一致，路线逐格相邻且长度最短
+    JumpPointSearch search;
+    QVector<QPoint> path;
+    for (quint32 seed = 1; seed <= 20; ++seed) {
+        const TileMap tiles = randomTiles(seed, 25, 25, 30);
+        auto open = [&tiles](int col, int row) { return tiles.tileAt(col, row) == TileMap::EMPTY; };
+        QRandomGenerator rng(seed);
+        for (int query = 0; query < 20; ++query) {
+            const QPoint start(1 + int(rng.bounded(23)), 1 + int(rng.bounded(23)));
+            const QPoint goal(1 + int(rng.bounded(23)), 1 + int(rng.bounded(23)));
+            if (!open(start.x(), start.y())) continue;
+            const QVector<int> dist = bruteForceDistances(tiles.columns(), tiles.rows(), QVector<QPoint>{ start }, open);
+            const int d = dist[goal.y() * tiles.columns() + goal.x()];
+
+            const bool found = search.findPath(tiles.columns(), tiles.rows(), start, goal, open, path);
+            QCOMPARE(found, d >= 0);
+            if (!found) continue;
+            QCOMPARE(path.size(), d + 1);
+            QCOMPARE(path.first(), start);
+            QCOMPARE(path.last(), goal);
+            for (int i = 1; i < path.size(); ++i) {
+                const QPoint delta = path[i] - path[i - 1];
+                QCOMPARE(qAbs(delta.x()) + qAbs(delta.y()), 1);
+                QVERIFY(open(path[i].x(), path[i].y()));
+            }
+        }
+    }
+}
+
+void TestCore::reservationTableCountsOverlaps()
+{
+    ReservationTable table;
+    table.reset(5, 5);
+    table.claim(1, 2, 2, 10, 20);
+
+    // 时间段左闭右开，只有重叠才算；自己的预约不算
+    QCOMPARE(table.cost(2, QPoint(0, 0), 2, 2, 15, 25), 1);
+    QCOMPARE(table.cost(2, QPoint(0, 0), 2, 2, 20, 30), 0);
+    QCOMPARE(table.cost(1, QPoint(0, 0), 2, 2, 15, 25), 0);
+
+    // 站着的身体也算，站在这一格的自己除外
+    table.addBody(QPoint(2, 2));
+    QCOMPARE(table.cost(2, QPoint(0, 0), 2, 2, 15, 25), 2);
+    QCOMPARE(table.cost(2, QPoint(2, 2), 2, 2, 15, 25), 1);
+
+    table.release(1);
+    QCOMPARE(table.cost(2, QPoint(0, 0), 2, 2, 15, 25), 1);
+    table.removeBody(QPoint(2, 2));
+    QCOMPARE(table.cost(2, QPoint(0, 0), 2, 2, 15, 25), 0);
+}
+
+void TestCore::sameTickFusesDetonateOnce()
+{
+    // 两颗相邻的炸弹同一个 tick 放下，引信同时燃尽，彼此都在对方的火焰里
+    // 每颗只能引爆一次：爆炸时定下的火焰定时器不能再被连锁重新排一遍
+    GameEngine engine;
+    engine.setSeed(1);
+    engine.initializeGame();
+    const TileMap &tiles = engine.tileMap();
+    QPoint first(-1, -1);
+    for (int row = 1; row < tiles.rows() - 1 && first.x() < 0; ++row) {
+        for (int col = 2; col < tiles.columns() - 2; ++col) {
+            if (tiles.tileAt(col, row) == TileMap::EMPTY && tiles.tileAt(col + 1, row) == TileMap::EMPTY) {
+                first = QPoint(col, row);
+                break;
+            }
+        }
+    }
+    QVERIFY(first.x() >= 0);
+
+    const int size = GameConstants::BLOCK_SIZE;
+    const QPoint positions[2] = { first * size, (first + QPoint(1, 0)) * size };
+    for (const QPoint &pos : positions) {
+        QVERIFY(engine.createBombAtCell(pos.x(), pos.y(), GameConstants::BOMB_RANGE));
+    }
+    Bomb *bombs[2] = { nullptr, nullptr };
+    for (Bomb *bomb : engine.bombs()) {
+        for (int i = 0; i < 2; ++i) {
+            if (bomb->getBombPosition() == positions[i]) bombs[i] = bomb;
+        }
+    }
+    QVERIFY(bombs[0] && bombs[1]);
+
+    int started[2] = { 0, 0 };
+    TimerWheel::TimerId flameTimers[2];
+    for (int i = 0; i < 2; ++i) {
+        connect(bombs[i], &Bomb::explosionStarted, this, [&started, &flameTimers, i](Bomb *bomb) {
+            ++started[i];
+            flameTimers[i] = bomb->timerId();
+        });
+    }
+
+    engine.advance(GameConstants::BOMB_FUSE_TICKS);
+    for (int i = 0; i < 2; ++i) {
+        QCOMPARE(started[i], 1);
+        QVERIFY(bombs[i]->isExploding());
+        QCOMPARE(bombs[i]->timerId().index, flameTimers[i].index);
+        QCOMPARE(bombs[i]->timerId().generation, flameTimers[i].generation);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestCore)
+#include "tst_core.moc"
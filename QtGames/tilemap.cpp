@@ -0,0 +1,34 @@
+#include "tilemap.h"
+
+TileMap::TileMap(int columns, int rows)
+    : m_columns(columns)
+    , m_rows(rows)
+    , m_tiles(columns * rows, EMPTY)
+    , m_brickCount(0)
+{
+}
+
+void TileMap::reset()
+{
+    m_tiles.fill(EMPTY);
+    m_brickCount = 0;
+}
+
+void TileMap::setTile(int col, int row, Tile tile)
+{
+    if (!contains(col, row)) return;
+    const int i = index(col, row);
+    m_brickCount += (tile == BRICK) - (m_tiles[i] == BRICK);
+    m_tiles[i] = tile;
+}
+
+TileMap::Tile TileMap::tileAtUnits(int x, int y) const
+{
+    if (x % GameConstants::BLOCK_SIZE != 0 || y % GameConstants::BLOCK_SIZE != 0) {
+        return EMPTY;
+    }
+    const int col = x / GameConstants::BLOCK_SIZE;
+    const int row = y / GameConstants::BLOCK_SIZE;
+    // 地图外没有方块图元，这里按空地处理，与原来的方块查找语义一致
+    return contains(col, row) ? static_cast<Tile>(m_tiles[index(col, row)]) : EMPTY;
+}
@@ -0,0 +1,56 @@
+#ifndef TILEMAP_H
+#define TILEMAP_H
+
+#include <QVector>
+#include "gameconstants.h"
+
+// 稠密地图：按方格（4x4逻辑单位）存储，每格1字节地形
+// 地图查询都是 O(1)，不再遍历方块列表；方块图元由渲染层按方格自行管理
+class TileMap
+{
+public:
+    enum Tile : quint8 {
+        EMPTY = 0,  // 空地
+        WALL  = 1,  // 不可破坏的墙
+        BRICK = 2   // 可破坏的砖块
+    };
+
+    explicit TileMap(int columns = GameConstants::MAP_GRID_COUNT,
+                     int rows = GameConstants::MAP_GRID_COUNT);
+
+    void reset();  // 清空地形
+
+    int columns() const { return m_columns; }
+    int rows() const { return m_rows; }
+    bool contains(int col, int row) const {
+        return col >= 0 && row >= 0 && col < m_columns && row < m_rows;
+    }
+
+    // 按方格坐标访问，越界视为墙
+    Tile tileAt(int col, int row) const {
+        return contains(col, row) ? static_cast<Tile>(m_tiles[index(col, row)]) : WALL;
+    }
+    bool isBlocked(int col, int row) const { return tileAt(col, row) != EMPTY; }
+    void setTile(int col, int row, Tile tile);
+
+    // 按逻辑单位访问：只有恰好落在方格原点上的坐标才对应一个方块，否则返回空地
+    Tile tileAtUnits(int x, int y) const;
+
+    // 逻辑单位 -> 方格坐标（向下取整，负数也正确）
+    static int cellOf(int units) {
+        return units >= 0 ? units / GameConstants::BLOCK_SIZE
+                          : -((-units + GameConstants::BLOCK_SIZE - 1) / GameConstants::BLOCK_SIZE);
+    }
+
+    int brickCount() const { return m_brickCount; }
+
+private:
+    int m_columns;
+    int m_rows;
+    QVector<quint8> m_tiles;   // 行优先，一行25字节
+    int m_brickCount;
+
+    int index(int col, int row) const { return row * m_columns + col; }
+};
+
+#endif // TILEMAP_H
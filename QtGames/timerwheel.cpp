@@ -0,0 +1,161 @@
+#include "timerwheel.h"
+
+TimerWheel::TimerWheel()
+    : m_buckets(OVERFLOW_BUCKET + 1)
+    , m_freeHead(-1)
+    , m_now(0)
+    , m_count(0)
+{
+}
+
+TimerWheel::TimerId TimerWheel::schedule(int delayTicks, quint32 kind, quint64 data)
+{
+    qint32 index = m_freeHead;
+    if (index >= 0) {
+        m_freeHead = m_nodes[index].next;
+    } else {
+        index = m_nodes.size();
+        Node node;
+        node.generation = 0;
+        m_nodes.append(node);
+    }
+
+    Node &node = m_nodes[index];
+    node.deadline = m_now + quint64(qMax(1, delayTicks));
+    node.data = data;
+    node.kind = kind;
+    link(index);
+    ++m_count;
+
+    TimerId id;
+    id.index = index;
+    id.generation = node.generation;
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id)
+{
+    if (!isActive(id)) return false;
+    unlink(id.index);
+    release(id.index);
+    return true;
+}
+
+bool TimerWheel::isActive(TimerId id) const
+{
+    return id.index >= 0 && id.index < m_nodes.size()
+           && m_nodes[id.index].generation == id.generation
+           && m_nodes[id.index].bucket >= 0;
+}
+
+int TimerWheel::remaining(TimerId id) const
+{
+    if (!isActive(id)) return -1;
+    return int(m_nodes[id.index].deadline - m_now);
+}
+
+void TimerWheel::advance(QVector<Expired> &expired)
+{
+    ++m_now;
+
+    // 进入新的低层周期时，把上一层对应槽里的定时器分散下来（先高层后低层）
+    if ((m_now & SLOT_MASK) == 0) {
+        if (((m_now >> SLOT_BITS) & SLOT_MASK) == 0) {
+            if (((m_now >> (2 * SLOT_BITS)) & SLOT_MASK) == 0) {
+                cascade(OVERFLOW_BUCKET);
+            }
+            cascade(2 * SLOTS + int((m_now >> (2 * SLOT_BITS)) & SLOT_MASK));
+        }
+        cascade(SLOTS + int((m_now >> SLOT_BITS) & SLOT_MASK));
+    }
+
+    Bucket &due = m_buckets[int(m_now & SLOT_MASK)];
+    while (due.head >= 0) {
+        const qint32 index = due.head;
+        unlink(index);
+        Expired e;
+        e.kind = m_nodes[index].kind;
+        e.data = m_nodes[index].data;
+        release(index);
+        expired.append(e);
+    }
+}
+
+void TimerWheel::clear()
+{
+    for (int i = 0; i < m_nodes.size(); ++i) {
+        if (m_nodes[i].bucket >= 0) {
+            release(i);
+        }
+    }
+    for (Bucket &bucket : m_buckets) {
+        bucket = Bucket();
+    }
+}
+
+int TimerWheel::bucketFor(quint64 deadline) const
+{
+    // 与当前时间处在同一个 64^(level+1) 周期内的放在该层，否则放到更高层
+    for (int level = 0; level < LEVELS; ++level) {
+        const int shift = SLOT_BITS * (level + 1);
+        if ((deadline >> shift) == (m_now >> shift)) {
+            return level * SLOTS + int((deadline >> (SLOT_BITS * level)) & SLOT_MASK);
+        }
+    }
+    return OVERFLOW_BUCKET;
+}
+
+void TimerWheel::link(qint32 index)
+{
+    Node &node = m_nodes[index];
+    node.bucket = bucketFor(node.deadline);
+    Bucket &bucket = m_buckets[node.bucket];
+    node.prev = bucket.tail;
+    node.next = -1;
+    if (bucket.tail >= 0) {
+        m_nodes[bucket.tail].next = index;
+    } else {
+        bucket.head = index;
+    }
+    bucket.tail = index;
+}
+
+void TimerWheel::unlink(qint32 index)
+{
+    Node &node = m_nodes[index];
+    Bucket &bucket = m_buckets[node.bucket];
+    if (node.prev >= 0) {
+        m_nodes[node.prev].next = node.next;
+    } else {
+        bucket.head = node.next;
+    }
+    if (node.next >= 0) {
+        m_nodes[node.next].prev = node.prev;
+    } else {
+        bucket.tail = node.prev;
+    }
+    node.prev = -1;
+    node.next = -1;
+}
+
+void TimerWheel::release(qint32 index)
+{
+    Node &node = m_nodes[index];
+    node.bucket = -1;
+    ++node.generation;  // 让旧的 TimerId 失效
+    node.next = m_freeHead;
+    m_freeHead = index;
+    --m_count;
+}
+
+void TimerWheel::cascade(int bucket)
+{
+    // 摘下整条链表后按原顺序重新挂到合适的槽
+    qint32 index = m_buckets[bucket].head;
+    m_buckets[bucket] = Bucket();
+    while (index >= 0) {
+        const qint32 next = m_nodes[index].next;
+        link(index);
+        index = next;
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <QVector>
+#include <QtGlobal>
+
+// 以 tick 为单位的分层时间轮，用于炸弹引信和火焰持续时间
+// 三层各 64 个槽（覆盖 64^3 个 tick），更远的定时器放在溢出桶里
+// 定时器节点放在池子里复用，插入/取消都是 O(1)，没有逐个定时器的堆分配
+// 时间只在 advance() 时前进，暂停对局只需停止调用 advance()
+class TimerWheel
+{
+public:
+    struct TimerId {
+        qint32 index = -1;
+        quint32 generation = 0;
+        bool isValid() const { return index >= 0; }
+    };
+    struct Expired {
+        quint32 kind;
+        quint64 data;
+    };
+
+    TimerWheel();
+
+    quint64 now() const { return m_now; }
+    int size() const { return m_count; }
+
+    // delayTicks 个 tick 之后到期（至少 1），kind/data 原样在到期时交还给调用方
+    TimerId schedule(int delayTicks, quint32 kind, quint64 data);
+    bool cancel(TimerId id);
+    bool isActive(TimerId id) const;
+    int remaining(TimerId id) const;  // 剩余 tick 数，定时器无效时返回 -1
+
+    // 推进一个 tick，把本 tick 到期的定时器按顺序追加到 expired
+    void advance(QVector<Expired> &expired);
+    void clear();  // 丢弃所有定时器，当前时间不变
+
+private:
+    enum : int {
+        SLOT_BITS = 6,
+        SLOTS = 1 << SLOT_BITS,
+        SLOT_MASK = SLOTS - 1,
+        LEVELS = 3,
+        OVERFLOW_BUCKET = LEVELS * SLOTS
+    };
+
+    struct Node {
+        quint64 deadline;
+        quint64 data;
+        quint32 kind;
+        quint32 generation;
+        qint32 prev;
+        qint32 next;
+        qint32 bucket;  // -1 表示空闲节点
+    };
+    struct Bucket {
+        qint32 head = -1;
+        qint32 tail = -1;
+    };
+
+    QVector<Node> m_nodes;
+    QVector<Bucket> m_buckets;
+    qint32 m_freeHead;
+    quint64 m_now;
+    int m_count;
+
+    int bucketFor(quint64 deadline) const;
+    void link(qint32 index);
+    void unlink(qint32 index);
+    void release(qint32 index);
+    void cascade(int bucket);
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,97 @@
+#include "walkabilitymap.h"
+#include "tilemap.h"
+
+WalkabilityMap::WalkabilityMap(int widthUnits, int heightUnits, int bodyUnits)
+    : m_widthUnits(widthUnits)
+    , m_heightUnits(heightUnits)
+    , m_bodyUnits(bodyUnits)
+    , m_columns((widthUnits + GameConstants::BLOCK_SIZE - 1) / GameConstants::BLOCK_SIZE)
+    , m_rows((heightUnits + GameConstants::BLOCK_SIZE - 1) / GameConstants::BLOCK_SIZE)
+    , m_tileBlocked(m_columns * m_rows, 0)
+    , m_bombCount(m_columns * m_rows, 0)
+    , m_blockFree(widthUnits, heightUnits)
+    , m_walkable(widthUnits, heightUnits)
+{
+}
+
+void WalkabilityMap::rebuild(const TileMap &tiles)
+{
+    for (int row = 0; row < m_rows; ++row) {
+        for (int col = 0; col < m_columns; ++col) {
+            m_tileBlocked[row * m_columns + col] = tiles.isBlocked(col, row) ? 1 : 0;
+        }
+    }
+    m_bombCount.fill(0);
+
+    for (int y = 0; y < m_heightUnits; ++y) {
+        for (int x = 0; x < m_widthUnits; ++x) {
+            refreshPosition(x, y);
+        }
+    }
+}
+
+void WalkabilityMap::setTileBlocked(int col, int row, bool blocked)
+{
+    if (col < 0 || row < 0 || col >= m_columns || row >= m_rows) return;
+    m_tileBlocked[row * m_columns + col] = blocked ? 1 : 0;
+    refreshAroundCell(col, row);
+}
+
+void WalkabilityMap::addBomb(int col, int row)
+{
+    if (col < 0 || row < 0 || col >= m_columns || row >= m_rows) return;
+    ++m_bombCount[row * m_columns + col];
+    refreshAroundCell(col, row);
+}
+
+void WalkabilityMap::removeBomb(int col, int row)
+{
+    if (col < 0 || row < 0 || col >= m_columns || row >= m_rows) return;
+    quint8 &count = m_bombCount[row * m_columns + col];
+    if (count == 0) return;
+    --count;
+    refreshAroundCell(col, row);
+}
+
+void WalkabilityMap::refreshPosition(int x, int y)
+{
+    // 越界的位置永远不可通行
+    if (x + m_bodyUnits > m_widthUnits || y + m_bodyUnits > m_heightUnits) {
+        m_blockFree.reset(x, y);
+        m_walkable.reset(x, y);
+        return;
+    }
+
+    // 玩家矩形 [x, x+body) 最多压到 2x2 个方格
+    const int minCol = x / GameConstants::BLOCK_SIZE;
+    const int maxCol = (x + m_bodyUnits - 1) / GameConstants::BLOCK_SIZE;
+    const int minRow = y / GameConstants::BLOCK_SIZE;
+    const int maxRow = (y + m_bodyUnits - 1) / GameConstants::BLOCK_SIZE;
+    bool tileFree = true;
+    bool bombFree = true;
+    for (int row = minRow; row <= maxRow; ++row) {
+        for (int col = minCol; col <= maxCol; ++col) {
+            const int i = row * m_columns + col;
+            if (m_tileBlocked[i]) tileFree = false;
+            if (m_bombCount[i]) bombFree = false;
+        }
+    }
+    m_blockFree.assign(x, y, tileFree);
+    m_walkable.assign(x, y, tileFree && bombFree);
+}
+
+void WalkabilityMap::refreshAroundCell(int col, int row)
+{
+    // 只有左上角落在 [cell - body + 1, cell + BLOCK_SIZE) 内的位置会压到这个格子
+    const int cellX = col * GameConstants::BLOCK_SIZE;
+    const int cellY = row * GameConstants::BLOCK_SIZE;
+    const int minX = qMax(0, cellX - m_bodyUnits + 1);
+    const int maxX = qMin(m_widthUnits - 1, cellX + GameConstants::BLOCK_SIZE - 1);
+    const int minY = qMax(0, cellY - m_bodyUnits + 1);
+    const int maxY = qMin(m_heightUnits - 1, cellY + GameConstants::BLOCK_SIZE - 1);
+    for (int y = minY; y <= maxY; ++y) {
+        for (int x = minX; x <= maxX; ++x) {
+            refreshPosition(x, y);
+        }
+    }
+}
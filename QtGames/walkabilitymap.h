@@ -0,0 +1,51 @@
+#ifndef WALKABILITYMAP_H
+#define WALKABILITYMAP_H
+
+#include <QVector>
+#include "gameconstants.h"
+#include "gridbitset.h"
+
+class TileMap;
+
+// 玩家体积的可通行位图（配置空间）：第 (x, y) 位表示左上角放在
+// 逻辑单位 (x, y) 的 4x4 玩家不越界、且不与墙/砖块/炸弹重叠
+// 只在砖块被炸毁、炸弹放下或移除时局部更新，查询只需测试一位
+class WalkabilityMap
+{
+public:
+    explicit WalkabilityMap(int widthUnits = GameConstants::MAP_SIZE_UNITS,
+                            int heightUnits = GameConstants::MAP_SIZE_UNITS,
+                            int bodyUnits = GameConstants::BLOCK_SIZE);
+
+    void rebuild(const TileMap &tiles);  // 按地图重建，同时清空炸弹
+    void setTileBlocked(int col, int row, bool blocked);
+    void addBomb(int col, int row);
+    void removeBomb(int col, int row);
+
+    // 不与墙/砖块/炸弹重叠
+    bool isWalkable(int x, int y) const { return m_walkable.test(x, y); }
+    // 只考虑墙和砖块，忽略炸弹
+    bool isFreeOfBlocks(int x, int y) const { return m_blockFree.test(x, y); }
+    bool hasBomb(int col, int row) const {
+        return col >= 0 && row >= 0 && col < m_columns && row < m_rows
+               && m_bombCount[row * m_columns + col] > 0;
+    }
+
+    const GridBitset &walkable() const { return m_walkable; }
+
+private:
+    int m_widthUnits;
+    int m_heightUnits;
+    int m_bodyUnits;
+    int m_columns;
+    int m_rows;
+    QVector<quint8> m_tileBlocked;  // 每格是否有墙/砖块
+    QVector<quint8> m_bombCount;    // 每格未爆炸的炸弹数
+    GridBitset m_blockFree;
+    GridBitset m_walkable;
+
+    void refreshPosition(int x, int y);
+    void refreshAroundCell(int col, int row);
+};
+
+#endif // WALKABILITYMAP_H